@@ -1,137 +1,180 @@
 ﻿// 8QuennsPuzzle.cpp : This file contains the 'main' function. Program execution begins and ends there.
 //
-#include <atomic>
-#include <experimental/generator>
+// usage: queens [--threads t] [--evaluator scalar|sse41|avx2] [--summary | --output file [--format csv|binary]]
+//                                                steepest descent from all 8^8 boards of 8-queens, drawing
+//                                                the first climb to every solution unless --summary; --output
+//                                                writes every climb reaching a solution to file instead
+//        queens --n n [--seed s] [--max-steps s] [--max-restarts r] [--print]
+//                                                min-conflicts on one board of n queens
+//        queens --batch first last [--threads t] [--seed s] [--max-steps s] [--max-restarts r]
+//                                                min-conflicts once for every n in [first, last]
+//        queens --strategy sideways|first-choice|restart|annealing [--trials t] [--seed s] [--max-steps s]
+//               [--max-restarts r] [--max-sideways k] [--schedule exponential|linear] [--temperature t] [--cooling d]
+//                                                stochastic local search on 8 queens from t random boards
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
-#include <limits>
-#include <locale>
-#include <mutex>
+#include <optional>
+#include <string>
 #include <thread>
-#include <vector>
 
-struct board_t
+#include "local_search.hpp"
+#include "nqueens.hpp"
+#include "queens.hpp"
+
+int main(int argc, char* argv[])
 {
-	unsigned int storage;
-	constexpr int queen_pos(int i) const noexcept
-	{
-		return (storage >> (3 * i)) & 7;
-	}
-	constexpr void set_queen_pos(int i, int v) noexcept
-	{
-		int mask = queen_pos(i) << (3 * i);
-		storage ^= mask;
-		storage |= (v << (3 * i));
-	}
-	constexpr int cost() const noexcept
+	queens::min_conflicts_options_t options;
+	queens::local_search_options_t local_options;
+	queens::exponential_schedule_t exponential;
+	std::string strategy, schedule = "exponential";
+	std::uint64_t trials = 1000;
+	std::uint32_t n = 0, first = 0, last = 0;
+	unsigned thread_count = std::max(1U, std::thread::hardware_concurrency());
+	bool batch = false, print = false, summary = false;
+	std::string output;
+	auto format = queens::record_format_t::csv;
+	auto evaluator = queens::fastest_evaluator();
+	for (int i = 1; i < argc; i++)
 	{
-		int ans = 0;
-		for (int i = 0; i != 7; i++)
+		std::string const arg = argv[i];
+		if ("--n" == arg && i + 1 < argc) n = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		else if ("--batch" == arg && i + 2 < argc)
 		{
-			auto const qi = queen_pos(i);
-			for (int j = i + 1; j != 8; j++)
-			{
-				auto const qj = queen_pos(j);
-				ans += (qi == qj);
-				auto const inc = j - i;
-				if (qi <= (7 - inc)) ans += ((qi + inc) == qj);
-				if (qi >= inc) ans += ((qi - inc) == qj);
-			}
+			batch = true;
+			first = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+			last = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
 		}
-		return ans;
-	}
-	std::experimental::generator<board_t> neighbors() const
-	{
-		for (int i = 0; i != 8; i++)
+		else if ("--threads" == arg && i + 1 < argc) thread_count = std::max(1, std::atoi(argv[++i]));
+		else if ("--seed" == arg && i + 1 < argc) options.seed = local_options.seed = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		else if ("--max-steps" == arg && i + 1 < argc) options.max_steps = local_options.max_steps = std::strtoull(argv[++i], nullptr, 10);
+		else if ("--max-restarts" == arg && i + 1 < argc)
 		{
-			auto const q = queen_pos(i);
-			for (int j = 0; j != 8; j++)
+			options.max_restarts = local_options.max_restarts = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if ("--strategy" == arg && i + 1 < argc) strategy = argv[++i];
+		else if ("--trials" == arg && i + 1 < argc) trials = std::strtoull(argv[++i], nullptr, 10);
+		else if ("--max-sideways" == arg && i + 1 < argc) local_options.max_sideways = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		else if ("--schedule" == arg && i + 1 < argc) schedule = argv[++i];
+		else if ("--temperature" == arg && i + 1 < argc) exponential.initial = std::atof(argv[++i]);
+		else if ("--cooling" == arg && i + 1 < argc) exponential.decay = std::atof(argv[++i]);
+		else if ("--print" == arg) print = true;
+		else if ("--summary" == arg) summary = true;
+		else if ("--output" == arg && i + 1 < argc) output = argv[++i];
+		else if ("--format" == arg && i + 1 < argc)
+		{
+			std::string const name = argv[++i];
+			if ("csv" == name) format = queens::record_format_t::csv;
+			else if ("binary" == name) format = queens::record_format_t::binary;
+			else
 			{
-				if (j == q) continue;
-				auto ans = *this;
-				ans.set_queen_pos(i, j);
-				co_yield ans;
+				std::cerr << "unknown format " << name << '\n';
+				return EXIT_FAILURE;
 			}
 		}
-	}
-	void print() const
-	{
-		for (int row = 0; row != 8; row++)
+		else if ("--evaluator" == arg && i + 1 < argc)
 		{
-			for (int i = 0; i != 8; i++)
+			std::string const name = argv[++i];
+			if ("scalar" == name) evaluator = queens::evaluator_t::scalar;
+			else if ("sse41" == name) evaluator = queens::evaluator_t::sse41;
+			else if ("avx2" == name) evaluator = queens::evaluator_t::avx2;
+			else
 			{
-				auto const q = queen_pos(i);
-				std::cout << ((row == q) ? "♕" : "◻");
+				std::cerr << "unknown evaluator " << name << '\n';
+				return EXIT_FAILURE;
 			}
-			std::cout << '\n';
 		}
-		std::cout << cost() << '\n';
+		else
+		{
+			std::cerr << "unknown argument " << arg << '\n';
+			return EXIT_FAILURE;
+		}
 	}
-};
-
-void hill_climbing(
-	board_t const start,
-	std::vector<std::atomic_flag>& processed,
-	std::atomic<int>& succeed,
-	std::atomic<int>& solutions)
-{
-	int min_cost = std::numeric_limits<int>::max();
-	for (auto current = start; /*!processed[current.storage].test_and_set()*/true;)
+	if (!batch && strategy.empty() && 0U == n)
 	{
-		board_t next = current;
-		for (auto const neighbor : current.neighbors())
+		if (evaluator > queens::fastest_evaluator())
+		{
+			std::cerr << "evaluator not supported by this processor\n";
+			return EXIT_FAILURE;
+		}
+		queens::climb_counters_t ans;
 		{
-			//if (processed[neighbor.storage].test()) continue;
-			if (auto const cost = neighbor.cost(); cost < min_cost)
+			std::ofstream file;
+			if (!output.empty())
 			{
-				min_cost = cost;
-				next = neighbor;
-				if (0 == min_cost)
+				file.open(output, queens::record_format_t::binary == format ? std::ios::binary : std::ios::out);
+				if (!file)
 				{
-					succeed.fetch_add(1);
-					if (!processed[neighbor.storage].test_and_set())
-					{
-						solutions.fetch_add(1);
-						static std::mutex m;
-						std::lock_guard g{ m };
-						start.print();
-						neighbor.print();
-					}
-					return;
+					std::cerr << "cannot open " << output << '\n';
+					return EXIT_FAILURE;
 				}
 			}
+			//written out by the time it goes out of scope
+			std::optional<queens::solution_log_t> log;
+			if (!output.empty()) log.emplace(file, format);
+			else if (!summary) log.emplace(std::cout, queens::record_format_t::boards);
+			ans = queens::sweep(log ? &*log : nullptr, thread_count, evaluator);
 		}
-		if (next.storage == current.storage)
+		std::cout << "evaluator: " << queens::with_evaluator(evaluator, [](auto const& kernel) { return kernel.name; }) << '\n';
+		std::cout << "solutions: " << ans.solutions << '\n';
+		std::cout << "fundamental solutions: " << ans.fundamental_solutions << '\n';
+		std::cout << "successed: " << ans.successes << '\n';
+		std::cout << "successed %: " << 100 * ans.success_rate() << '\n';
+		ans.write_json(std::cout);
+		std::cout << '\n';
+		return 0;
+	}
+	if (!strategy.empty())
+	{
+		queens::local_search_report_t ans;
+		if ("sideways" == strategy) ans = queens::local_search_trials(queens::sideways_climbing_t{ local_options }, trials, local_options.seed);
+		else if ("first-choice" == strategy) ans = queens::local_search_trials(queens::first_choice_climbing_t{ local_options }, trials, local_options.seed);
+		else if ("restart" == strategy)
 		{
-			return;
+			ans = queens::local_search_trials(queens::random_restart_t<queens::sideways_climbing_t>{ local_options }, trials, local_options.seed);
 		}
-		current = next;
-	}
-}
-
-int main()
-{
-	std::vector<std::atomic_flag> processed(8 * 8 * 8 * 8 * 8 * 8 * 8 * 8);
-	std::atomic<int> succeed = 0, solutions = 0;
-	std::vector<std::jthread> tasks;
-	tasks.reserve(std::thread::hardware_concurrency());
-	auto task = [&processed, &succeed, &solutions](unsigned int first, unsigned int last)
+		else if ("annealing" == strategy && "linear" == schedule)
 		{
-			for (unsigned int i = first; i < last; i++)
-			{
-				hill_climbing(board_t{ i }, processed, succeed, solutions);
-			}
-		};
-	int const chunk = processed.size() / std::thread::hardware_concurrency();
-	for (size_t i = 0; i != std::thread::hardware_concurrency(); i++)
+			queens::linear_schedule_t const linear{ exponential.initial, local_options.max_steps };
+			ans = queens::local_search_trials(queens::simulated_annealing_t<queens::linear_schedule_t>{ local_options, linear }, trials, local_options.seed);
+		}
+		else if ("annealing" == strategy)
+		{
+			ans = queens::local_search_trials(queens::simulated_annealing_t<>{ local_options, exponential }, trials, local_options.seed);
+		}
+		else
+		{
+			std::cerr << "unknown strategy " << strategy << '\n';
+			return EXIT_FAILURE;
+		}
+		std::cout << "solved: " << ans.solved() << " of " << ans.trials << '\n';
+		std::cout << "expected time to a solution: " << ans.expected_time() << " s\n";
+		ans.write_json(std::cout);
+		std::cout << '\n';
+		return EXIT_SUCCESS;
+	}
+	if (batch)
 	{
-		tasks.emplace_back(task, chunk * i, chunk * (i + 1));
+		auto const ans = queens::min_conflicts_batch(first, last, options, thread_count);
+		std::cout << "solved: " << ans.successes << " of " << (last >= first ? last - first + 1U : 0U) << '\n';
+		ans.write_json(std::cout);
+		std::cout << '\n';
+		return EXIT_SUCCESS;
 	}
-	for (auto& task : tasks)
+	queens::nqueens_t board{ n };
+	queens::climb_counters_t counters;
+	bool const solved = queens::min_conflicts_t{ options }(board, counters);
+	std::cout << "solved: " << (solved ? "true" : "false") << '\n';
+	if (solved && print)
 	{
-		task.join();
+		for (auto const row : board.rows())
+		{
+			std::cout << row << ' ';
+		}
+		std::cout << '\n';
 	}
-	std::cout << "solutions: " << solutions << '\n';
-	std::cout << "successed: " << succeed << '\n';
-	std::cout << "successed %: " << float(100*succeed) / processed.size() << '\n';
-	return 0;
-}
\ No newline at end of file
+	counters.write_json(std::cout);
+	std::cout << '\n';
+	return solved ? EXIT_SUCCESS : EXIT_FAILURE;
+}
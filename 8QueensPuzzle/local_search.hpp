@@ -0,0 +1,338 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <ostream>
+#include <random>
+#include <vector>
+
+#include "../Common/counters.hpp"
+#include "queens.hpp"
+
+//Stochastic local search on the 8-queens board_t, a solution from one random start at a
+//time rather than every start. Every strategy is called on a board it leaves at the end of
+//its search, returns true on a solution and counts: climbs, searches started; steps, moves
+//made; evaluations, neighbors whose cost was computed; restarts, searches that failed;
+//plateaus, moves that did not lower the cost; final_costs, the cost every search ended at.
+namespace queens
+{
+struct local_search_options_t
+{
+	//consecutive moves to a neighbor as good as the current board before a climb gives up;
+	//0 stops at the first plateau like hill_climbing()
+	std::uint32_t max_sideways = 100U;
+	//moves, or annealing steps, per search
+	std::uint64_t max_steps = 10000U;
+	//climbs after the first one for random_restart_t
+	std::uint32_t max_restarts = 1000U;
+	std::uint32_t seed = 20240101U;
+};
+
+inline board_t random_board(std::mt19937& gen)
+{
+	return board_t{ std::uniform_int_distribution<unsigned>{ 0U, 8U * 8 * 8 * 8 * 8 * 8 * 8 * 8 - 1U }(gen) };
+}
+
+//counts the end of a search at cost, true on a solution
+inline bool search_ended(int const cost, climb_counters_t& counters)
+{
+	counters.final_costs.add(static_cast<std::size_t>(cost));
+	if (0 != cost)
+	{
+		counters.restarts++;
+		return false;
+	}
+	counters.successes++;
+	counters.solutions++;
+	return true;
+}
+
+//Steepest descent taking the lowest neighbor, ties broken at random, that also moves to a
+//neighbor as good as the current board up to max_sideways times in a row.
+class sideways_climbing_t
+{
+public:
+	explicit sideways_climbing_t(local_search_options_t const& options = {})
+		: m_options{ options }, m_gen{ options.seed }
+	{
+	}
+	bool operator()(board_t& board, climb_counters_t& counters)
+	{
+		counters.climbs++;
+		conflicts_t conflicts{ board };
+		std::uint32_t sideways = 0;
+		for (std::uint64_t step = 0; 0 != conflicts.cost() && step != m_options.max_steps; step++)
+		{
+			int best = std::numeric_limits<int>::max(), best_column = 0, best_row = 0;
+			std::uint32_t ties = 0;
+			counters.evaluations += 56U;
+			for (int i = 0; i != 8; i++)
+			{
+				auto const q = board.queen_pos(i);
+				auto const remaining = conflicts.cost() - conflicts.leaving(i, q);
+				for (int j = 0; j != 8; j++)
+				{
+					if (j == q) continue;
+					auto const cost = remaining + conflicts.joining(i, j);
+					//the k-th tie replaces the pick with probability 1 / k, so all of them are equally likely
+					if (cost < best)
+					{
+						best = cost;
+						ties = 1U;
+					}
+					else if (cost != best || 0U != std::uniform_int_distribution<std::uint32_t>{ 0U, ties++ }(m_gen))
+					{
+						continue;
+					}
+					best_column = i;
+					best_row = j;
+				}
+			}
+			if (best > conflicts.cost()) break;
+			if (best == conflicts.cost())
+			{
+				if (sideways++ == m_options.max_sideways) break;
+				counters.plateaus++;
+			}
+			else
+			{
+				sideways = 0;
+			}
+			counters.steps++;
+			conflicts.move(best_column, board.queen_pos(best_column), best_row);
+			board.set_queen_pos(best_column, best_row);
+		}
+		return search_ended(conflicts.cost(), counters);
+	}
+private:
+	local_search_options_t m_options;
+	std::mt19937 m_gen;
+};
+
+//First-choice hill climbing: neighbors are drawn at random without replacement and the
+//first one better than the current board is taken; a climb stops once all 56 were drawn.
+class first_choice_climbing_t
+{
+public:
+	explicit first_choice_climbing_t(local_search_options_t const& options = {})
+		: m_options{ options }, m_gen{ options.seed }
+	{
+		//8 * column + the row counted from the one after the queen
+		for (int i = 0; i != 56; i++)
+		{
+			m_moves[i] = 8 * (i / 7) + i % 7;
+		}
+	}
+	bool operator()(board_t& board, climb_counters_t& counters)
+	{
+		counters.climbs++;
+		conflicts_t conflicts{ board };
+		for (std::uint64_t step = 0; 0 != conflicts.cost() && step != m_options.max_steps; step++)
+		{
+			bool moved = false;
+			for (int drawn = 0; drawn != 56 && !moved; drawn++)
+			{
+				std::swap(m_moves[drawn], m_moves[std::uniform_int_distribution<int>{ drawn, 55 }(m_gen)]);
+				auto const i = m_moves[drawn] / 8, q = board.queen_pos(i), j = (q + 1 + m_moves[drawn] % 8) % 8;
+				counters.evaluations++;
+				if (conflicts.joining(i, j) < conflicts.leaving(i, q))
+				{
+					conflicts.move(i, q, j);
+					board.set_queen_pos(i, j);
+					moved = true;
+				}
+			}
+			if (!moved) break;
+			counters.steps++;
+		}
+		return search_ended(conflicts.cost(), counters);
+	}
+private:
+	local_search_options_t m_options;
+	std::mt19937 m_gen;
+	std::array<int, 56> m_moves;
+};
+
+//Climbs with climber_t from the board, then from random boards, up to max_restarts times
+//after the first climb.
+template <typename climber_t>
+class random_restart_t
+{
+public:
+	explicit random_restart_t(local_search_options_t const& options = {})
+		: m_climber{ options }, m_options{ options }, m_gen{ options.seed + 1U }
+	{
+	}
+	bool operator()(board_t& board, climb_counters_t& counters)
+	{
+		for (std::uint32_t attempt = 0;; attempt++)
+		{
+			if (m_climber(board, counters)) return true;
+			if (attempt == m_options.max_restarts) return false;
+			board = random_board(m_gen);
+		}
+	}
+private:
+	climber_t m_climber;
+	local_search_options_t m_options;
+	std::mt19937 m_gen;
+};
+
+//temperature initial * decay^step, 0 once it falls below minimum
+struct exponential_schedule_t
+{
+	double initial = 2.0;
+	double decay = 0.999;
+	double minimum = 0.001;
+	double operator()(std::uint64_t const step) const
+	{
+		auto const temperature = initial * std::pow(decay, static_cast<double>(step));
+		return temperature < minimum ? 0.0 : temperature;
+	}
+};
+
+//temperature falling from initial to 0 in steps steps
+struct linear_schedule_t
+{
+	double initial = 2.0;
+	std::uint64_t steps = 10000U;
+	double operator()(std::uint64_t const step) const
+	{
+		return step >= steps ? 0.0 : initial * static_cast<double>(steps - step) / static_cast<double>(steps);
+	}
+};
+
+//Simulated annealing: every step draws a random neighbor and moves to it if it is no worse,
+//or with probability exp(-delta / temperature) if it is worse by delta. schedule_t maps
+//the step to the temperature; the search stops when it reaches 0.
+template <typename schedule_t = exponential_schedule_t>
+class simulated_annealing_t
+{
+public:
+	explicit simulated_annealing_t(local_search_options_t const& options = {}, schedule_t schedule = {})
+		: m_options{ options }, m_schedule{ schedule }, m_gen{ options.seed }
+	{
+	}
+	bool operator()(board_t& board, climb_counters_t& counters)
+	{
+		counters.climbs++;
+		conflicts_t conflicts{ board };
+		for (std::uint64_t step = 0; 0 != conflicts.cost() && step != m_options.max_steps; step++)
+		{
+			auto const temperature = m_schedule(step);
+			if (temperature <= 0.0) break;
+			auto const i = std::uniform_int_distribution<int>{ 0, 7 }(m_gen), q = board.queen_pos(i);
+			auto const j = (q + std::uniform_int_distribution<int>{ 1, 7 }(m_gen)) % 8;
+			auto const delta = conflicts.joining(i, j) - conflicts.leaving(i, q);
+			counters.evaluations++;
+			if (delta > 0 && std::uniform_real_distribution<double>{}(m_gen) >= std::exp(-delta / temperature)) continue;
+			counters.steps++;
+			counters.plateaus += delta >= 0;
+			conflicts.move(i, q, j);
+			board.set_queen_pos(i, j);
+		}
+		return search_ended(conflicts.cost(), counters);
+	}
+private:
+	local_search_options_t m_options;
+	schedule_t m_schedule;
+	std::mt19937 m_gen;
+};
+
+//Independent trials of one strategy, each from its own random board. What matters is the
+//wall time until a solution, so besides the counters every solved trial records its time
+//and steps; expected_time() charges the failed trials to the solved ones, the expected
+//wall time to a solution when a failed trial is simply run again.
+struct local_search_report_t
+{
+	std::uint64_t trials = 0;
+	double total_time = 0.0;
+	//seconds and steps of the solved trials, sorted once the trials are done
+	std::vector<double> solution_times;
+	std::vector<std::uint64_t> solution_steps;
+	climb_counters_t counters;
+
+	std::uint64_t solved() const noexcept
+	{
+		return solution_times.size();
+	}
+	double success_rate() const noexcept
+	{
+		return 0U == trials ? 0.0 : static_cast<double>(solved()) / static_cast<double>(trials);
+	}
+	double expected_time() const noexcept
+	{
+		return 0U == solved() ? std::numeric_limits<double>::infinity() : total_time / static_cast<double>(solved());
+	}
+	void write_json(std::ostream& os) const
+	{
+		os << "{\"trials\":" << trials
+			<< ",\"solved\":" << solved()
+			<< ",\"success_rate\":" << success_rate()
+			<< ",\"total_time_s\":" << total_time
+			<< ",\"expected_time_s\":";
+		if (0U == solved()) os << "null";
+		else os << expected_time();
+		os << ",\"time_to_solution_s\":";
+		write_quantiles(os, solution_times);
+		os << ",\"steps_to_solution\":";
+		write_quantiles(os, solution_steps);
+		os << ",\"counters\":";
+		counters.write_json(os);
+		os << '}';
+	}
+private:
+	template <typename value_t>
+	static void write_quantiles(std::ostream& os, std::vector<value_t> const& sorted)
+	{
+		if (sorted.empty())
+		{
+			os << "null";
+			return;
+		}
+		auto const at = [&sorted](double const q) { return sorted[static_cast<std::size_t>(q * static_cast<double>(sorted.size() - 1U))]; };
+		os << "{\"min\":" << sorted.front()
+			<< ",\"p50\":" << at(0.5)
+			<< ",\"p90\":" << at(0.9)
+			<< ",\"p99\":" << at(0.99)
+			<< ",\"max\":" << sorted.back()
+			<< ",\"mean\":" << std::accumulate(sorted.begin(), sorted.end(), 0.0) / static_cast<double>(sorted.size())
+			<< '}';
+	}
+};
+
+//trials runs of strategy, the starting boards drawn from seed
+template <typename strategy_t>
+local_search_report_t local_search_trials(strategy_t strategy, std::uint64_t const trials, std::uint32_t const seed)
+{
+	using clock_t = std::chrono::steady_clock;
+	local_search_report_t ans;
+	std::mt19937 gen{ seed };
+	{
+		scoped_phase_t const phase{ ans.counters.phases, "trials" };
+		for (; ans.trials < trials; ans.trials++)
+		{
+			auto board = random_board(gen);
+			auto const steps = ans.counters.steps;
+			auto const begin = clock_t::now();
+			bool const solved = strategy(board, ans.counters);
+			auto const elapsed = std::chrono::duration<double>(clock_t::now() - begin).count();
+			ans.total_time += elapsed;
+			if (solved)
+			{
+				ans.solution_times.push_back(elapsed);
+				ans.solution_steps.push_back(ans.counters.steps - steps);
+			}
+		}
+	}
+	std::ranges::sort(ans.solution_times);
+	std::ranges::sort(ans.solution_steps);
+	return ans;
+}
+}
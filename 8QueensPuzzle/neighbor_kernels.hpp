@@ -0,0 +1,196 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define QUEENS_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+//GCC and clang only emit AVX2 or SSE4.1 instructions in functions marked for them, so the
+//kernels build without -mavx2 and are picked at run time; MSVC emits them anywhere.
+#if defined(QUEENS_X86) && (defined(__GNUC__) || defined(__clang__))
+#define QUEENS_TARGET(isa) __attribute__((target(isa)))
+#else
+#define QUEENS_TARGET(isa)
+#endif
+
+//Kernels scoring the 56 neighbors of an 8-queens board in one batch, from the queens per
+//row and per diagonal that conflicts_t keeps. The neighbor moving the queen of column i
+//to row j costs cost - (pairs the queen leaves) + rows[j] + diagonals[j + i] +
+//anti_diagonals[j - i + 7]; for one column the 8 rows are 8 adjacent counts of every
+//array, one vector of 8 lanes. Every kernel returns the same lowest cost and set.
+namespace queens
+{
+//the lowest neighbor cost and the neighbors that have it, bit 8 * column + row
+struct lowest_neighbors_t
+{
+	int cost;
+	std::uint64_t moves;
+};
+
+struct scalar_evaluator_t
+{
+	static constexpr char const* name = "scalar";
+	lowest_neighbors_t operator()(unsigned const storage, std::array<int, 8> const& rows, std::array<int, 15> const& diagonals,
+		std::array<int, 15> const& anti_diagonals, int const cost) const noexcept
+	{
+		std::array<int, 64> costs;
+		for (int i = 0; i != 8; i++)
+		{
+			auto const q = static_cast<int>((storage >> (3 * i)) & 7U);
+			auto const remaining = cost - (rows[q] + diagonals[q + i] + anti_diagonals[q - i + 7] - 3);
+			for (int j = 0; j != 8; j++)
+			{
+				costs[8 * i + j] = remaining + rows[j] + diagonals[j + i] + anti_diagonals[j - i + 7];
+			}
+			costs[8 * i + q] = std::numeric_limits<int>::max();
+		}
+		lowest_neighbors_t ans{ std::numeric_limits<int>::max(), 0U };
+		for (auto const neighbor_cost : costs)
+		{
+			ans.cost = std::min(ans.cost, neighbor_cost);
+		}
+		for (int k = 0; k != 64; k++)
+		{
+			ans.moves |= static_cast<std::uint64_t>(costs[k] == ans.cost) << k;
+		}
+		return ans;
+	}
+};
+
+#ifdef QUEENS_X86
+struct sse41_evaluator_t
+{
+	static constexpr char const* name = "sse41";
+	QUEENS_TARGET("sse4.1")
+	lowest_neighbors_t operator()(unsigned const storage, std::array<int, 8> const& rows, std::array<int, 15> const& diagonals,
+		std::array<int, 15> const& anti_diagonals, int const cost) const noexcept
+	{
+		//rows 0-3 and 4-7 of every column
+		__m128i costs[16];
+		auto const row_counts_low = _mm_loadu_si128(reinterpret_cast<__m128i const*>(rows.data()));
+		auto const row_counts_high = _mm_loadu_si128(reinterpret_cast<__m128i const*>(rows.data() + 4));
+		auto const lanes_low = _mm_setr_epi32(0, 1, 2, 3), lanes_high = _mm_setr_epi32(4, 5, 6, 7);
+		auto const infinity = _mm_set1_epi32(std::numeric_limits<int>::max());
+		auto lowest = infinity;
+		for (int i = 0; i != 8; i++)
+		{
+			auto const q = static_cast<int>((storage >> (3 * i)) & 7U);
+			auto const remaining = _mm_set1_epi32(cost - (rows[q] + diagonals[q + i] + anti_diagonals[q - i + 7] - 3));
+			auto const queen = _mm_set1_epi32(q);
+			auto const low = _mm_add_epi32(_mm_add_epi32(remaining, row_counts_low),
+				_mm_add_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(diagonals.data() + i)),
+					_mm_loadu_si128(reinterpret_cast<__m128i const*>(anti_diagonals.data() + 7 - i))));
+			auto const high = _mm_add_epi32(_mm_add_epi32(remaining, row_counts_high),
+				_mm_add_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(diagonals.data() + i + 4)),
+					_mm_loadu_si128(reinterpret_cast<__m128i const*>(anti_diagonals.data() + 11 - i))));
+			costs[2 * i] = _mm_blendv_epi8(low, infinity, _mm_cmpeq_epi32(lanes_low, queen));
+			costs[2 * i + 1] = _mm_blendv_epi8(high, infinity, _mm_cmpeq_epi32(lanes_high, queen));
+			lowest = _mm_min_epi32(lowest, _mm_min_epi32(costs[2 * i], costs[2 * i + 1]));
+		}
+		lowest = _mm_min_epi32(lowest, _mm_shuffle_epi32(lowest, _MM_SHUFFLE(1, 0, 3, 2)));
+		lowest = _mm_min_epi32(lowest, _mm_shuffle_epi32(lowest, _MM_SHUFFLE(2, 3, 0, 1)));
+		lowest_neighbors_t ans{ _mm_cvtsi128_si32(lowest), 0U };
+		for (int k = 0; k != 16; k++)
+		{
+			auto const equal = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(costs[k], lowest)));
+			ans.moves |= static_cast<std::uint64_t>(equal) << (4 * k);
+		}
+		return ans;
+	}
+};
+
+struct avx2_evaluator_t
+{
+	static constexpr char const* name = "avx2";
+	QUEENS_TARGET("avx2")
+	lowest_neighbors_t operator()(unsigned const storage, std::array<int, 8> const& rows, std::array<int, 15> const& diagonals,
+		std::array<int, 15> const& anti_diagonals, int const cost) const noexcept
+	{
+		__m256i costs[8];
+		auto const row_counts = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(rows.data()));
+		auto const lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+		auto const infinity = _mm256_set1_epi32(std::numeric_limits<int>::max());
+		auto lowest = infinity;
+		for (int i = 0; i != 8; i++)
+		{
+			auto const q = static_cast<int>((storage >> (3 * i)) & 7U);
+			auto const remaining = _mm256_set1_epi32(cost - (rows[q] + diagonals[q + i] + anti_diagonals[q - i + 7] - 3));
+			auto const neighbors = _mm256_add_epi32(_mm256_add_epi32(remaining, row_counts),
+				_mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(diagonals.data() + i)),
+					_mm256_loadu_si256(reinterpret_cast<__m256i const*>(anti_diagonals.data() + 7 - i))));
+			costs[i] = _mm256_blendv_epi8(neighbors, infinity, _mm256_cmpeq_epi32(lanes, _mm256_set1_epi32(q)));
+			lowest = _mm256_min_epi32(lowest, costs[i]);
+		}
+		auto half = _mm_min_epi32(_mm256_castsi256_si128(lowest), _mm256_extracti128_si256(lowest, 1));
+		half = _mm_min_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+		half = _mm_min_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+		lowest_neighbors_t ans{ _mm_cvtsi128_si32(half), 0U };
+		auto const broadcast = _mm256_set1_epi32(ans.cost);
+		for (int i = 0; i != 8; i++)
+		{
+			auto const equal = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(costs[i], broadcast)));
+			ans.moves |= static_cast<std::uint64_t>(equal) << (8 * i);
+		}
+		return ans;
+	}
+};
+#endif
+
+enum class evaluator_t
+{
+	scalar,
+	sse41,
+	avx2,
+};
+
+//the widest kernel the processor runs
+inline evaluator_t fastest_evaluator() noexcept
+{
+#if defined(QUEENS_X86) && defined(_MSC_VER)
+	int registers[4];
+	__cpuid(registers, 0);
+	auto const leaves = registers[0];
+	__cpuid(registers, 1);
+	auto const sse41 = 0 != (registers[2] & (1 << 19));
+	//AVX2 also needs the operating system to save the ymm registers
+	auto const avx = 0 != (registers[2] & (1 << 27)) && 0 != (registers[2] & (1 << 28)) && 6U == (_xgetbv(0) & 6U);
+	bool avx2 = false;
+	if (leaves >= 7)
+	{
+		__cpuidex(registers, 7, 0);
+		avx2 = avx && 0 != (registers[1] & (1 << 5));
+	}
+	return avx2 ? evaluator_t::avx2 : sse41 ? evaluator_t::sse41 : evaluator_t::scalar;
+#elif defined(QUEENS_X86)
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2") ? evaluator_t::avx2 : __builtin_cpu_supports("sse4.1") ? evaluator_t::sse41 : evaluator_t::scalar;
+#else
+	return evaluator_t::scalar;
+#endif
+}
+
+//calls visit with the kernel of evaluator, the scalar one where the build has no other
+template <typename visitor_t>
+decltype(auto) with_evaluator(evaluator_t const evaluator, visitor_t&& visit)
+{
+	switch (evaluator)
+	{
+#ifdef QUEENS_X86
+	case evaluator_t::avx2:
+		return visit(avx2_evaluator_t{});
+	case evaluator_t::sse41:
+		return visit(sse41_evaluator_t{});
+#endif
+	default:
+		return visit(scalar_evaluator_t{});
+	}
+}
+}
@@ -0,0 +1,326 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "../Common/counters.hpp"
+#include "queens.hpp"
+
+namespace queens
+{
+//N queens, one per column, with the number of queens on every row and diagonal, so
+//the queens attacking any square are counted in O(1), and the set of empty rows.
+//About 32 bytes per column.
+class nqueens_t
+{
+public:
+	explicit nqueens_t(std::uint32_t const n)
+		: m_rows(n), m_row_counts(n), m_diagonals(2U * std::max(n, 1U) - 1U), m_anti_diagonals(2U * std::max(n, 1U) - 1U),
+		m_empty_slots(n)
+	{
+		clear();
+	}
+	std::uint32_t size() const noexcept
+	{
+		return static_cast<std::uint32_t>(m_rows.size());
+	}
+	std::uint32_t queen_pos(std::uint32_t const column) const noexcept
+	{
+		return m_rows[column];
+	}
+	std::vector<std::uint32_t> const& rows() const noexcept
+	{
+		return m_rows;
+	}
+	//queens of the other columns attacking the queen of column
+	std::uint32_t conflicts(std::uint32_t const column) const noexcept
+	{
+		return attacks(column, m_rows[column]) - 3U;
+	}
+	//attacking pairs, the sum of n * (n - 1) / 2 over rows and diagonals
+	std::uint64_t cost() const noexcept
+	{
+		std::uint64_t ans = 0;
+		for (auto const* counts : { &m_row_counts, &m_diagonals, &m_anti_diagonals })
+		{
+			for (std::uint64_t const n : *counts)
+			{
+				ans += n * (n - 1U) / 2U;
+			}
+		}
+		return ans;
+	}
+private:
+	friend class min_conflicts_t;
+	//queens on the lines through (column, row), counting one standing there three times
+	std::uint32_t attacks(std::uint32_t const column, std::uint32_t const row) const noexcept
+	{
+		return m_row_counts[row] + m_diagonals[row + column] + m_anti_diagonals[row + size() - 1U - column];
+	}
+	void clear()
+	{
+		std::ranges::fill(m_row_counts, 0U);
+		std::ranges::fill(m_diagonals, 0U);
+		std::ranges::fill(m_anti_diagonals, 0U);
+		m_empty_rows.resize(size());
+		std::iota(m_empty_rows.begin(), m_empty_rows.end(), 0U);
+		std::iota(m_empty_slots.begin(), m_empty_slots.end(), 0U);
+	}
+	void place(std::uint32_t const column, std::uint32_t const row) noexcept
+	{
+		if (0U == m_row_counts[row]++)
+		{
+			auto const last = m_empty_rows.back();
+			m_empty_rows[m_empty_slots[row]] = last;
+			m_empty_slots[last] = m_empty_slots[row];
+			m_empty_rows.pop_back();
+		}
+		m_rows[column] = row;
+		m_diagonals[row + column]++;
+		m_anti_diagonals[row + size() - 1U - column]++;
+	}
+	void lift(std::uint32_t const column)
+	{
+		auto const row = m_rows[column];
+		if (0U == --m_row_counts[row])
+		{
+			m_empty_slots[row] = static_cast<std::uint32_t>(m_empty_rows.size());
+			m_empty_rows.push_back(row);
+		}
+		m_diagonals[row + column]--;
+		m_anti_diagonals[row + size() - 1U - column]--;
+	}
+	std::vector<std::uint32_t> m_rows;
+	std::vector<std::uint32_t> m_row_counts;
+	//row + column
+	std::vector<std::uint32_t> m_diagonals;
+	//row - column + n - 1
+	std::vector<std::uint32_t> m_anti_diagonals;
+	//rows without a queen, and the position of every such row in that list
+	std::vector<std::uint32_t> m_empty_rows;
+	std::vector<std::uint32_t> m_empty_slots;
+};
+
+struct min_conflicts_options_t
+{
+	//repair steps per attempt before starting over; 0 picks 1000 + n / 100
+	std::uint64_t max_steps = 0U;
+	//attempts after the first one before giving up, e.g. for n = 2 or 3
+	std::uint32_t max_restarts = 50U;
+	std::uint32_t seed = 20240101U;
+};
+
+//Min-conflicts local search. An attempt places the queens column by column, each on
+//the least attacked of a few random empty rows, stopping at the first one no placed
+//queen attacks along a diagonal; only the last columns usually start in conflict.
+//Every repair step picks a random attacked queen and moves it to the row of its
+//column with the fewest attackers, ties broken at random. Only empty rows can be
+//free of attackers, so they are examined first and the whole column only when none
+//of them is. An attempt that runs out of steps is a restart. Counters: climbs are
+//attempts, steps repair moves, evaluations rows examined, plateaus moves that left
+//the queen as attacked as before.
+class min_conflicts_t
+{
+public:
+	explicit min_conflicts_t(min_conflicts_options_t const& options = {})
+		: m_options{ options }, m_gen{ options.seed }
+	{
+	}
+	//true once board holds a solution
+	bool operator()(nqueens_t& board, climb_counters_t& counters)
+	{
+		auto const n = board.size();
+		auto const max_steps = 0U != m_options.max_steps ? m_options.max_steps : 1000U + n / 100U;
+		for (std::uint32_t attempt = 0; attempt <= m_options.max_restarts; attempt++)
+		{
+			counters.climbs++;
+			{
+				scoped_phase_t const phase{ counters.phases, "init" };
+				initialize(board);
+			}
+			bool solved;
+			{
+				scoped_phase_t const phase{ counters.phases, "repair" };
+				solved = repair(board, max_steps, counters);
+			}
+			if (solved)
+			{
+				counters.successes++;
+				counters.solutions++;
+				counters.final_costs.add(0U);
+				return true;
+			}
+			counters.restarts++;
+			counters.final_costs.add(static_cast<std::size_t>(board.cost()));
+		}
+		return false;
+	}
+private:
+	constexpr static std::uint32_t placement_tries = 32U;
+	std::uint32_t uniform(std::uint32_t const first, std::uint32_t const last)
+	{
+		return std::uniform_int_distribution<std::uint32_t>{ first, last }(m_gen);
+	}
+	void initialize(nqueens_t& board)
+	{
+		auto const n = board.size();
+		board.clear();
+		for (std::uint32_t column = 0; column < n; column++)
+		{
+			auto best = std::numeric_limits<std::uint32_t>::max();
+			std::uint32_t best_row = 0;
+			for (std::uint32_t i = 0; i < placement_tries && 0U != best; i++)
+			{
+				auto const row = board.m_empty_rows[uniform(0U, n - 1U - column)];
+				if (auto const attackers = board.attacks(column, row); attackers < best)
+				{
+					best = attackers;
+					best_row = row;
+				}
+			}
+			board.place(column, best_row);
+		}
+	}
+	void collect_conflicts(nqueens_t const& board)
+	{
+		m_conflicted.clear();
+		for (std::uint32_t column = 0; column < board.size(); column++)
+		{
+			if (0U != board.conflicts(column)) m_conflicted.push_back(column);
+		}
+	}
+	//the least attacked of rows for the queen of column, ties broken at random: one pass
+	//finds the minimum and counts its rows, a second one stops at the drawn row
+	template <typename rows_t>
+	std::pair<std::uint32_t, std::uint32_t> least_attacked(nqueens_t const& board, std::uint32_t const column, rows_t const& rows)
+	{
+		auto best = std::numeric_limits<std::uint32_t>::max();
+		std::uint32_t ties = 0;
+		for (auto const row : rows)
+		{
+			if (auto const attackers = board.attacks(column, row); attackers < best)
+			{
+				best = attackers;
+				ties = 1U;
+			}
+			else
+			{
+				ties += attackers == best;
+			}
+		}
+		if (0U == ties) return { best, 0U };
+		auto pick = uniform(0U, ties - 1U);
+		for (auto const row : rows)
+		{
+			if (board.attacks(column, row) == best && 0U == pick--) return { best, row };
+		}
+		return { best, 0U };
+	}
+	//the queens sharing a line with the queen of column, found by one pass over the rows,
+	//which is cheaper than the step's own scan of the column
+	void enlist_attackers(nqueens_t const& board, std::uint32_t const column)
+	{
+		auto const row = board.m_rows[column];
+		for (std::uint32_t other = 0; other < board.size(); other++)
+		{
+			auto const other_row = board.m_rows[other];
+			if (other != column && (other_row == row || other_row + other == row + column || other_row + column == row + other))
+			{
+				m_conflicted.push_back(other);
+			}
+		}
+	}
+	//The conflicted list may hold queens that are no longer attacked; they are dropped
+	//when drawn. A queen moved to an attacked square stays listed and lists its
+	//attackers, so the list only runs dry on a solution, which a last scan confirms.
+	bool repair(nqueens_t& board, std::uint64_t const max_steps, climb_counters_t& counters)
+	{
+		auto const n = board.size();
+		collect_conflicts(board);
+		for (std::uint64_t step = 0;;)
+		{
+			if (m_conflicted.empty())
+			{
+				collect_conflicts(board);
+				if (m_conflicted.empty()) return true;
+			}
+			auto const pick = uniform(0U, static_cast<std::uint32_t>(m_conflicted.size() - 1U));
+			auto const column = m_conflicted[pick];
+			auto const before = board.conflicts(column);
+			if (0U == before)
+			{
+				m_conflicted[pick] = m_conflicted.back();
+				m_conflicted.pop_back();
+				continue;
+			}
+			if (step++ == max_steps) return false;
+			counters.steps++;
+			board.lift(column);
+			counters.evaluations += board.m_empty_rows.size();
+			auto [best, best_row] = least_attacked(board, column, board.m_empty_rows);
+			if (0U != best)
+			{
+				counters.evaluations += n;
+				std::tie(best, best_row) = least_attacked(board, column, std::views::iota(0U, n));
+			}
+			counters.plateaus += best == before;
+			board.place(column, best_row);
+			if (0U == best)
+			{
+				m_conflicted[pick] = m_conflicted.back();
+				m_conflicted.pop_back();
+			}
+			else
+			{
+				enlist_attackers(board, column);
+			}
+		}
+	}
+	min_conflicts_options_t m_options;
+	std::mt19937 m_gen;
+	std::vector<std::uint32_t> m_conflicted;
+};
+
+//One min-conflicts solve per n in [first, last], spread over thread_count threads;
+//every n is seeded with seed + n so the outcome does not depend on the schedule.
+inline climb_counters_t min_conflicts_batch(std::uint32_t const first, std::uint32_t const last,
+	min_conflicts_options_t const& options = {}, unsigned const thread_count = std::max(1U, std::thread::hardware_concurrency()))
+{
+	climb_counters_t ans;
+	std::vector<climb_counters_t> counters(thread_count);
+	std::atomic<std::uint32_t> next{ first };
+	{
+		scoped_phase_t const phase{ ans.phases, "batch" };
+		std::vector<std::jthread> tasks;
+		tasks.reserve(thread_count);
+		for (auto& thread_counters : counters)
+		{
+			tasks.emplace_back([&next, &options, &thread_counters, last]()
+				{
+					for (auto n = next++; n <= last; n = next++)
+					{
+						auto instance_options = options;
+						instance_options.seed += n;
+						nqueens_t board{ n };
+						min_conflicts_t{ instance_options }(board, thread_counters);
+					}
+				});
+		}
+	}
+	for (auto const& thread_counters : counters)
+	{
+		ans.merge(thread_counters);
+	}
+	return ans;
+}
+}
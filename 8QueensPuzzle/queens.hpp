@@ -0,0 +1,585 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../Common/atomic_bitmap.hpp"
+#include "../Common/batch_writer.hpp"
+#include "../Common/counters.hpp"
+#include "../Common/inline_buffer.hpp"
+#include "../Common/range_scheduler.hpp"
+#include "neighbor_kernels.hpp"
+
+namespace queens
+{
+struct board_t
+{
+	unsigned int storage;
+	constexpr int queen_pos(int i) const noexcept
+	{
+		return (storage >> (3 * i)) & 7;
+	}
+	constexpr void set_queen_pos(int i, int v) noexcept
+	{
+		int mask = queen_pos(i) << (3 * i);
+		storage ^= mask;
+		storage |= (v << (3 * i));
+	}
+	constexpr int cost() const noexcept
+	{
+		int ans = 0;
+		for (int i = 0; i != 7; i++)
+		{
+			auto const qi = queen_pos(i);
+			for (int j = i + 1; j != 8; j++)
+			{
+				auto const qj = queen_pos(j);
+				ans += (qi == qj);
+				auto const inc = j - i;
+				if (qi <= (7 - inc)) ans += ((qi + inc) == qj);
+				if (qi >= inc) ans += ((qi - inc) == qj);
+			}
+		}
+		return ans;
+	}
+	//Symmetries. Only the identity, the two reflections below and their product, the half
+	//turn, map every board of one queen per column to another such board; a quarter turn
+	//or a diagonal reflection turns columns into rows, so it applies to boards with one
+	//queen per row as well, e.g. solutions, through transposed().
+	//rows upside down
+	constexpr board_t flipped_rows() const noexcept
+	{
+		return board_t{ storage ^ 0xFFFFFFU };
+	}
+	//columns right to left
+	constexpr board_t flipped_columns() const noexcept
+	{
+		board_t ans{ 0U };
+		for (int i = 0; i != 8; i++)
+		{
+			ans.storage |= static_cast<unsigned>(queen_pos(i)) << (3 * (7 - i));
+		}
+		return ans;
+	}
+	//bit 0 of symmetry flips the columns, bit 1 the rows; every one is its own inverse
+	constexpr board_t image(unsigned const symmetry) const noexcept
+	{
+		auto const ans = 0U != (symmetry & 1U) ? flipped_columns() : *this;
+		return 0U != (symmetry & 2U) ? ans.flipped_rows() : ans;
+	}
+	//the least board of its orbit under those 4 symmetries
+	constexpr board_t canonical() const noexcept
+	{
+		auto ans = *this;
+		for (unsigned symmetry = 1; symmetry != 4; symmetry++)
+		{
+			ans.storage = std::min(ans.storage, image(symmetry).storage);
+		}
+		return ans;
+	}
+	//reflection about the main diagonal, the queen of column i going to column queen_pos(i);
+	//a board only if every row holds one queen
+	constexpr board_t transposed() const noexcept
+	{
+		board_t ans{ 0U };
+		for (int i = 0; i != 8; i++)
+		{
+			ans.storage |= static_cast<unsigned>(i) << (3 * queen_pos(i));
+		}
+		return ans;
+	}
+	//the least board of its orbit under all 8 rotations and reflections, for boards of
+	//one queen per row and per column
+	constexpr board_t canonical_permutation() const noexcept
+	{
+		return board_t{ std::min(canonical().storage, transposed().canonical().storage) };
+	}
+	//one queen moved within its column: 8 * 7 boards, in place
+	using successors_t = inline_buffer_t<board_t, 56>;
+	constexpr successors_t neighbors() const noexcept
+	{
+		successors_t ans;
+		for_each_neighbor([&ans](board_t const& neighbor) { ans.push_back(neighbor); });
+		return ans;
+	}
+	template <typename visitor_t>
+	constexpr void for_each_neighbor(visitor_t&& visit) const
+	{
+		for (int i = 0; i != 8; i++)
+		{
+			auto const q = queen_pos(i);
+			for (int j = 0; j != 8; j++)
+			{
+				if (j == q) continue;
+				auto ans = *this;
+				ans.set_queen_pos(i, j);
+				visit(ans);
+			}
+		}
+	}
+	void print(std::ostream& os = std::cout) const
+	{
+		for (int row = 0; row != 8; row++)
+		{
+			for (int i = 0; i != 8; i++)
+			{
+				auto const q = queen_pos(i);
+				os << ((row == q) ? "♕" : "◻");
+			}
+			os << '\n';
+		}
+		os << cost() << '\n';
+	}
+};
+
+//Per thread climb statistics, merged once the sweep is done.
+struct climb_counters_t
+{
+	std::uint64_t climbs = 0;
+	std::uint64_t successes = 0;
+	//distinct solutions, each counted by the first climb reaching it
+	std::uint64_t solutions = 0;
+	//of those, distinct up to rotation and reflection; only counted by the sweep
+	std::uint64_t fundamental_solutions = 0;
+	std::uint64_t steps = 0;
+	//neighbors whose cost was computed
+	std::uint64_t evaluations = 0;
+	//failed climbs; a random restart driver starts over after each of them
+	std::uint64_t restarts = 0;
+	//failed climbs that stopped on a plateau, next to a board as good as the current one
+	std::uint64_t plateaus = 0;
+	//cost of the board every climb stopped at
+	histogram_t final_costs;
+	phase_timings_t phases;
+
+	double success_rate() const noexcept
+	{
+		return 0U == climbs ? 0.0 : static_cast<double>(successes) / climbs;
+	}
+	void merge(climb_counters_t const& other)
+	{
+		climbs += other.climbs;
+		successes += other.successes;
+		solutions += other.solutions;
+		fundamental_solutions += other.fundamental_solutions;
+		steps += other.steps;
+		evaluations += other.evaluations;
+		restarts += other.restarts;
+		plateaus += other.plateaus;
+		final_costs.merge(other.final_costs);
+		phases.merge(other.phases);
+	}
+	void write_json(std::ostream& os) const
+	{
+		os << "{\"climbs\":" << climbs
+			<< ",\"successes\":" << successes
+			<< ",\"success_rate\":" << success_rate()
+			<< ",\"solutions\":" << solutions
+			<< ",\"fundamental_solutions\":" << fundamental_solutions
+			<< ",\"steps\":" << steps
+			<< ",\"evaluations\":" << evaluations
+			<< ",\"restarts\":" << restarts
+			<< ",\"plateaus\":" << plateaus
+			<< ",\"final_costs\":";
+		final_costs.write_json(os);
+		os << ",\"phases\":";
+		phases.write_json(os);
+		os << '}';
+	}
+};
+
+//a climb that reached a solution, the boards as board_t::storage
+struct solution_record_t
+{
+	std::uint32_t start;
+	std::uint32_t solution;
+	std::uint32_t steps;
+};
+
+enum class record_format_t
+{
+	//both boards drawn by print()
+	boards,
+	//start,solution,steps with every board as its 8 queen rows from column 0
+	csv,
+	//12 bytes per record, the three fields in host byte order
+	binary,
+};
+
+//Solution records written to a stream by a background thread, so climbing workers never
+//wait on the output. The boards format only gets the first climb reaching each solution;
+//the others get every climb reaching one.
+class solution_log_t
+{
+public:
+	solution_log_t(std::ostream& os, record_format_t const format)
+		: m_every_climb{ record_format_t::boards != format },
+		m_writer{ [&os, format](std::vector<solution_record_t> const& records) { write(os, format, records); } }
+	{
+		if (record_format_t::csv == format) os << "start,solution,steps\n";
+	}
+private:
+	friend class solution_sink_t;
+	static void write(std::ostream& os, record_format_t const format, std::vector<solution_record_t> const& records)
+	{
+		static_assert(12U == sizeof(solution_record_t));
+		if (record_format_t::binary == format)
+		{
+			os.write(reinterpret_cast<char const*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(solution_record_t)));
+			return;
+		}
+		for (auto const& record : records)
+		{
+			board_t const start{ record.start }, solution{ record.solution };
+			if (record_format_t::boards == format)
+			{
+				start.print(os);
+				solution.print(os);
+				continue;
+			}
+			for (auto const board : { start, solution })
+			{
+				for (int i = 0; i != 8; i++)
+				{
+					os << static_cast<char>('0' + board.queen_pos(i));
+				}
+				os << ',';
+			}
+			os << record.steps << '\n';
+		}
+	}
+	bool m_every_climb;
+	batch_writer_t<solution_record_t> m_writer;
+};
+
+//one worker's end of a solution_log_t
+class solution_sink_t
+{
+public:
+	explicit solution_sink_t(solution_log_t& log)
+		: m_buffer{ log.m_writer }, m_every_climb{ log.m_every_climb }
+	{
+	}
+	//a climb from start reached solution in steps steps, as the first one if first
+	void reached(board_t const start, board_t const solution, std::uint32_t const steps, bool const first)
+	{
+		if (first || m_every_climb) m_buffer.push_back({ start.storage, solution.storage, steps });
+	}
+private:
+	batch_buffer_t<solution_record_t> m_buffer;
+	bool m_every_climb;
+};
+
+//Queens per row and per diagonal of one board. The cost is the number of attacking
+//pairs, the sum of n * (n - 1) / 2 over those lines. A queen moved within its column
+//only leaves three lines and joins three others, so the cost of every neighbor is
+//known in O(1) from the counts of the current board.
+class conflicts_t
+{
+public:
+	explicit constexpr conflicts_t(board_t const board) noexcept
+	{
+		for (int i = 0; i != 8; i++)
+		{
+			auto const q = board.queen_pos(i);
+			m_cost += m_rows[q] + m_diagonals[q + i] + m_anti_diagonals[q - i + 7];
+			add(i, q, 1);
+		}
+	}
+	constexpr int cost() const noexcept
+	{
+		return m_cost;
+	}
+	//pairs the queen of column i leaves when it leaves row q
+	constexpr int leaving(int const i, int const q) const noexcept
+	{
+		return m_rows[q] + m_diagonals[q + i] + m_anti_diagonals[q - i + 7] - 3;
+	}
+	//pairs a queen of column i forms in row j, j not being its current row
+	constexpr int joining(int const i, int const j) const noexcept
+	{
+		return m_rows[j] + m_diagonals[j + i] + m_anti_diagonals[j - i + 7];
+	}
+	constexpr void move(int const i, int const from, int const to) noexcept
+	{
+		m_cost += joining(i, to) - leaving(i, from);
+		add(i, from, -1);
+		add(i, to, 1);
+	}
+	//the lowest cost among the neighbors of board, which these counts are of, scored by one
+	//of the kernels of neighbor_kernels.hpp
+	template <typename kernel_t>
+	lowest_neighbors_t lowest_neighbors(board_t const board, kernel_t const& kernel) const noexcept
+	{
+		return kernel(board.storage, m_rows, m_diagonals, m_anti_diagonals, m_cost);
+	}
+private:
+	constexpr void add(int const i, int const q, int const n) noexcept
+	{
+		m_rows[q] += n;
+		m_diagonals[q + i] += n;
+		m_anti_diagonals[q - i + 7] += n;
+	}
+	std::array<int, 8> m_rows{};
+	//row + column
+	std::array<int, 15> m_diagonals{};
+	//row - column + 7
+	std::array<int, 15> m_anti_diagonals{};
+	int m_cost = 0;
+};
+
+//Steepest descent: every step scans the 56 neighbors in neighbors() order and takes the
+//first one with the lowest cost, costs coming from the conflict counts of the current board.
+inline void hill_climbing(
+	board_t const start,
+	atomic_bitmap_t& processed,
+	climb_counters_t& counters,
+	solution_sink_t* const sink = nullptr)
+{
+	int min_cost = std::numeric_limits<int>::max();
+	counters.climbs++;
+	conflicts_t conflicts{ start };
+	std::uint32_t steps = 0;
+	for (auto current = start;;)
+	{
+		int best_column = -1, best_row = -1;
+		bool plateau = false;
+		counters.steps++;
+		steps++;
+		for (int i = 0; i != 8; i++)
+		{
+			auto const q = current.queen_pos(i);
+			auto const remaining = conflicts.cost() - conflicts.leaving(i, q);
+			for (int j = 0; j != 8; j++)
+			{
+				if (j == q) continue;
+				counters.evaluations++;
+				if (auto const cost = remaining + conflicts.joining(i, j); cost < min_cost)
+				{
+					min_cost = cost;
+					best_column = i;
+					best_row = j;
+					if (0 == min_cost)
+					{
+						auto solution = current;
+						solution.set_queen_pos(i, j);
+						counters.successes++;
+						counters.final_costs.add(0U);
+						auto const first = !processed.test_and_set(solution.storage);
+						counters.solutions += first;
+						if (nullptr != sink) sink->reached(start, solution, steps, first);
+						return;
+					}
+				}
+				else if (cost == min_cost)
+				{
+					plateau = true;
+				}
+			}
+		}
+		if (best_column < 0)
+		{
+			counters.restarts++;
+			counters.plateaus += plateau;
+			counters.final_costs.add(static_cast<std::size_t>(min_cost));
+			return;
+		}
+		conflicts.move(best_column, current.queen_pos(best_column), best_row);
+		current.set_queen_pos(best_column, best_row);
+	}
+}
+
+//The climbs of hill_climbing() from every board of the orbit of start, run as one. The
+//climb from start.image(s) is the image of a climb from start that scans the columns and
+//the rows in the directions s flips: all of them see the same neighbor costs and only
+//part ways on a step whose lowest cost is shared by neighbors those scan orders reach
+//in a different order. The counts are the ones of the separate climbs. kernel_t scores
+//the neighbors of every step.
+template <typename kernel_t>
+void orbit_climbing(
+	board_t const start,
+	board_t current,
+	conflicts_t conflicts,
+	int min_cost,
+	std::uint32_t steps,
+	std::span<unsigned> symmetries,
+	atomic_bitmap_t& processed,
+	climb_counters_t& counters,
+	solution_sink_t* const sink,
+	kernel_t const& kernel)
+{
+	for (;;)
+	{
+		auto const climbs = symmetries.size();
+		counters.steps += climbs;
+		steps++;
+		//the lowest cost counts from the cost of the current board, so the set of neighbors
+		//that have it is empty when no neighbor is as good
+		auto const neighbors = conflicts.lowest_neighbors(current, kernel);
+		auto const lowest = std::min(min_cost, neighbors.cost);
+		auto const lowest_moves = neighbors.cost == lowest ? neighbors.moves : std::uint64_t{ 0 };
+		if (lowest == min_cost)
+		{
+			counters.evaluations += 56U * climbs;
+			counters.restarts += climbs;
+			counters.plateaus += 0U != lowest_moves ? climbs : 0U;
+			counters.final_costs.add(static_cast<std::size_t>(min_cost), climbs);
+			return;
+		}
+		//the first neighbor of the lowest cost in the scan order of symmetry, as 8 * column + row
+		auto const first_lowest = [lowest_moves](unsigned const symmetry)
+			{
+				auto const i = 0U != (symmetry & 1U) ? 7 - std::countl_zero(lowest_moves) / 8 : std::countr_zero(lowest_moves) / 8;
+				auto const rows = static_cast<std::uint8_t>(lowest_moves >> (8 * i));
+				auto const j = 0U != (symmetry & 2U) ? 7 - std::countl_zero(rows) : std::countr_zero(rows);
+				return 8 * i + j;
+			};
+		if (0 == lowest)
+		{
+			for (auto const symmetry : symmetries)
+			{
+				auto const move = first_lowest(symmetry);
+				auto const i = move / 8, j = move % 8, q = current.queen_pos(i);
+				//neighbors scanned up to it: 7 per column before its own, then the rows before its own
+				auto const column_rank = 0U != (symmetry & 1U) ? 7 - i : i;
+				auto const row_rank = 0U != (symmetry & 2U) ? 7 - j : j;
+				auto const queen_rank = 0U != (symmetry & 2U) ? 7 - q : q;
+				auto solution = current;
+				solution.set_queen_pos(i, j);
+				solution = solution.image(symmetry);
+				counters.successes++;
+				counters.evaluations += static_cast<std::uint64_t>(7 * column_rank + row_rank - (queen_rank < row_rank) + 1);
+				counters.final_costs.add(0U);
+				auto const first = !processed.test_and_set(solution.storage);
+				counters.solutions += first;
+				if (nullptr != sink) sink->reached(start.image(symmetry), solution, steps, first);
+			}
+			return;
+		}
+		counters.evaluations += 56U * climbs;
+		std::array<std::pair<int, unsigned>, 4> moves;
+		for (std::size_t k = 0; k != climbs; k++)
+		{
+			moves[k] = { first_lowest(symmetries[k]), symmetries[k] };
+		}
+		std::sort(moves.begin(), moves.begin() + climbs);
+		for (std::size_t k = 0; k != climbs; k++)
+		{
+			symmetries[k] = moves[k].second;
+		}
+		//climbs taking the same neighbor are now next to each other; every group but the
+		//last one goes on in a call of its own, the last one right here
+		std::size_t first = 0;
+		for (std::size_t k = 1; k <= climbs; k++)
+		{
+			if (k != climbs && moves[k].first == moves[first].first) continue;
+			auto const i = moves[first].first / 8, j = moves[first].first % 8;
+			if (k == climbs)
+			{
+				conflicts.move(i, current.queen_pos(i), j);
+				current.set_queen_pos(i, j);
+				symmetries = symmetries.subspan(first);
+				break;
+			}
+			auto next = current;
+			auto next_conflicts = conflicts;
+			next_conflicts.move(i, current.queen_pos(i), j);
+			next.set_queen_pos(i, j);
+			orbit_climbing(start, next, next_conflicts, lowest, steps, symmetries.subspan(first, k - first), processed, counters, sink, kernel);
+			first = k;
+		}
+		min_cost = lowest;
+	}
+}
+
+//the climbs from the distinct boards of the orbit of start
+template <typename kernel_t>
+void orbit_climbing(board_t const start, atomic_bitmap_t& processed, climb_counters_t& counters, solution_sink_t* const sink, kernel_t const& kernel)
+{
+	std::array<unsigned, 4> symmetries;
+	std::size_t count = 0;
+	for (unsigned symmetry = 0; symmetry != 4; symmetry++)
+	{
+		auto const image = start.image(symmetry);
+		auto const seen = std::span{ symmetries }.first(count);
+		if (std::ranges::none_of(seen, [start, image](unsigned const other) { return start.image(other).storage == image.storage; }))
+		{
+			symmetries[count++] = symmetry;
+		}
+	}
+	counters.climbs += count;
+	orbit_climbing(start, start, conflicts_t{ start }, std::numeric_limits<int>::max(), 0U, std::span{ symmetries }.first(count), processed, counters,
+		sink, kernel);
+}
+
+//Steepest descent hill climbing from every one of the 8^8 boards. Mirroring a board
+//top to bottom or left to right mirrors its climb but for ties, so the boards are
+//climbed an orbit at a time by orbit_climbing(), started from the least board of every
+//orbit. Climbs differ a lot in length, so the starts are handed out in small chunks by
+//a work stealing scheduler. evaluator picks the kernel scoring the neighbors; all of
+//them give the same counts. Climbs reaching a solution go to log, when there is one.
+inline climb_counters_t sweep(solution_log_t* const log, unsigned const thread_count = std::max(1U, std::thread::hardware_concurrency()),
+	evaluator_t const evaluator = fastest_evaluator())
+{
+	constexpr std::uint32_t board_count = 8 * 8 * 8 * 8 * 8 * 8 * 8 * 8;
+	constexpr std::uint32_t chunk = 1024;
+	climb_counters_t ans;
+	atomic_bitmap_t processed{ board_count };
+	range_scheduler_t scheduler{ 0U, board_count, thread_count, chunk };
+	std::vector<climb_counters_t> counters(thread_count);
+	{
+		scoped_phase_t const phase{ ans.phases, "sweep" };
+		std::vector<std::jthread> tasks;
+		tasks.reserve(thread_count);
+		for (unsigned worker = 0; worker < thread_count; worker++)
+		{
+			tasks.emplace_back([&processed, &scheduler, &counters, log, worker, evaluator]()
+				{
+					//counted and buffered locally, so the workers never share a cache line
+					climb_counters_t local;
+					std::optional<solution_sink_t> sink;
+					if (nullptr != log) sink.emplace(*log);
+					with_evaluator(evaluator, [&](auto const& kernel)
+						{
+							while (auto const range = scheduler.next(worker))
+							{
+								for (auto i = range->first; i < range->second; i++)
+								{
+									if (board_t const start{ i }; start.canonical().storage == i)
+									{
+										orbit_climbing(start, processed, local, sink ? &*sink : nullptr, kernel);
+									}
+								}
+							}
+						});
+					counters[worker] = std::move(local);
+				});
+		}
+	}
+	for (auto const& thread_counters : counters)
+	{
+		ans.merge(thread_counters);
+	}
+	std::vector<std::uint32_t> fundamental;
+	for (std::uint32_t i = 0; i < board_count; i++)
+	{
+		if (processed.test(i)) fundamental.push_back(board_t{ i }.canonical_permutation().storage);
+	}
+	std::ranges::sort(fundamental);
+	ans.fundamental_solutions = static_cast<std::uint64_t>(std::ranges::unique(fundamental).begin() - fundamental.begin());
+	return ans;
+}
+}
@@ -0,0 +1,392 @@
+// benchmark.cpp : fixed seed benchmark of the N-puzzle and 8-queens searches.
+//
+// usage: benchmark [--suite 8puzzle|15puzzle|24puzzle|queens|nqueens|localsearch]... [--algorithm astar|idastar|hdastar|bibfs|mm|smastar|ara]...
+//                  [--instances n] [--korf100 file] [--pdb file]... [--threads n] [--max-nodes n]
+//                  [--weight w] [--time-ms n]
+// Prints one JSON line per suite and algorithm. Without --korf100 the 15-puzzle suite
+// uses fixed seed random walks, as does the 24-puzzle suite; the file uses the npuzzle
+// --batch line format. The nqueens suite solves one board of a million queens with
+// min-conflicts, then one board for each of n = 4 .. instances + 3. The localsearch suite
+// runs every 8-queens local search strategy from instances random boards.
+//
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <ranges>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "../8QueensPuzzle/local_search.hpp"
+#include "../8QueensPuzzle/nqueens.hpp"
+#include "../8QueensPuzzle/queens.hpp"
+#include "../NPuzzle/npuzzle.hpp"
+#include "../NPuzzle/npuzzle_anytime.hpp"
+#include "../NPuzzle/npuzzle_bidirectional.hpp"
+#include "../NPuzzle/npuzzle_bounded.hpp"
+#include "../NPuzzle/npuzzle_heuristic.hpp"
+#include "../NPuzzle/npuzzle_parallel.hpp"
+#include "../NPuzzle/npuzzle_solver.hpp"
+
+namespace
+{
+	constexpr std::uint32_t seed = 20240101U;
+
+	//Linux lets us reset the high water mark between runs; elsewhere the peak is process wide.
+	void reset_peak_rss()
+	{
+#ifdef __linux__
+		std::ofstream{ "/proc/self/clear_refs" } << "5";
+#endif
+	}
+
+	std::uint64_t peak_rss_kb()
+	{
+#ifdef _WIN32
+		PROCESS_MEMORY_COUNTERS counters{};
+		::GetProcessMemoryInfo(::GetCurrentProcess(), &counters, sizeof(counters));
+		return counters.PeakWorkingSetSize / 1024U;
+#else
+#ifdef __linux__
+		std::ifstream status{ "/proc/self/status" };
+		for (std::string line; std::getline(status, line);)
+		{
+			if (0 == line.rfind("VmHWM:", 0))
+			{
+				return std::stoull(line.substr(6));
+			}
+		}
+#endif
+		rusage usage{};
+		::getrusage(RUSAGE_SELF, &usage);
+		return static_cast<std::uint64_t>(usage.ru_maxrss);
+#endif
+	}
+
+	struct totals_t
+	{
+		std::uint64_t instances = 0;
+		std::uint64_t solved = 0;
+		std::uint64_t total_length = 0;
+		std::uint64_t expansions = 0;
+		std::uint64_t generated = 0;
+	};
+
+	template <typename counters_t>
+	void report(std::string const& suite, std::string const& algorithm, totals_t const& totals, std::chrono::duration<double> const wall_time,
+		counters_t const& counters)
+	{
+		std::cout << "{\"suite\":\"" << suite << "\",\"algorithm\":\"" << algorithm << '"'
+			<< ",\"instances\":" << totals.instances
+			<< ",\"solved\":" << totals.solved
+			<< ",\"total_length\":" << totals.total_length
+			<< ",\"expansions\":" << totals.expansions
+			<< ",\"generated\":" << totals.generated
+			<< ",\"wall_time_s\":" << wall_time.count()
+			<< ",\"nodes_per_sec\":" << (wall_time.count() > 0 ? totals.expansions / wall_time.count() : 0.0)
+			<< ",\"peak_rss_kb\":" << peak_rss_kb()
+			<< ",\"counters\":";
+		counters.write_json(std::cout);
+		std::cout << "}\n" << std::flush;
+	}
+
+	template <std::uint8_t side_size, typename engine_t>
+	void run(std::string const& suite, std::string const& algorithm, engine_t engine, std::vector<board_t<side_size>> const& instances)
+	{
+		std::array<std::uint8_t, board_t<side_size>::board_size> cells;
+		std::iota(cells.begin(), cells.end(), std::uint8_t{ 0 });
+		board_t<side_size> const goal{ cells };
+		totals_t totals;
+		search_counters_t counters;
+		reset_peak_rss();
+		auto const begin = std::chrono::steady_clock::now();
+		for (auto const& instance : instances)
+		{
+			auto const ans = engine(instance, goal);
+			totals.instances++;
+			totals.solved += ans.solved;
+			totals.total_length += ans.depth;
+			counters.merge(ans.counters);
+		}
+		auto const wall_time = std::chrono::steady_clock::now() - begin;
+		totals.expansions = counters.expansions;
+		totals.generated = counters.generations;
+		report(suite, algorithm, totals, wall_time, counters);
+	}
+
+	template <std::uint8_t side_size, typename heuristic_t>
+	void run_algorithms(std::string const& suite, std::vector<std::string> const& algorithms, heuristic_t const& heuristic,
+		unsigned const thread_count, std::size_t const max_nodes, anytime_options_t const& anytime, std::vector<board_t<side_size>> const& instances)
+	{
+		for (auto const& algorithm : algorithms)
+		{
+			if ("astar" == algorithm) run<side_size>(suite, algorithm, astar_t<side_size, heuristic_t const&>{ heuristic }, instances);
+			if ("idastar" == algorithm) run<side_size>(suite, algorithm, idastar_t<side_size, heuristic_t const&>{ heuristic }, instances);
+			if ("hdastar" == algorithm) run<side_size>(suite, algorithm, hdastar_t<side_size, heuristic_t const&>{ heuristic, thread_count }, instances);
+			if ("bibfs" == algorithm) run<side_size>(suite, algorithm, bibfs_t<side_size>{}, instances);
+			if ("mm" == algorithm) run<side_size>(suite, algorithm, mm_t<side_size>{}, instances);
+			if ("smastar" == algorithm) run<side_size>(suite, algorithm, smastar_t<side_size, heuristic_t const&>{ heuristic, max_nodes }, instances);
+			if ("ara" == algorithm) run<side_size>(suite, algorithm, ara_t<side_size, heuristic_t const&>{ heuristic, anytime }, instances);
+		}
+	}
+
+	std::vector<board_t<3>> random_8puzzles(std::size_t const count)
+	{
+		std::mt19937 gen{ seed };
+		std::array<std::uint8_t, 9> init{ 0,1,2,3,4,5,6,7,8 };
+		std::vector<board_t<3>> ans;
+		while (ans.size() < count)
+		{
+			std::ranges::shuffle(init, gen);
+			if (board_t<3> const board{ init }; board.solvable()) ans.push_back(board);
+		}
+		return ans;
+	}
+
+	template <std::uint8_t side_size>
+	std::vector<board_t<side_size>> random_walks(std::size_t const count, std::size_t const length)
+	{
+		std::mt19937 gen{ seed };
+		std::array<std::uint8_t, board_t<side_size>::board_size> cells;
+		std::iota(cells.begin(), cells.end(), std::uint8_t{ 0 });
+		std::vector<board_t<side_size>> ans;
+		while (ans.size() < count)
+		{
+			board_t<side_size> board{ cells };
+			auto previous = board;
+			for (std::size_t step = 0; step < length; step++)
+			{
+				std::vector<board_t<side_size>> children;
+				for (auto const& child : board.neighbors())
+				{
+					if (!(child == previous)) children.push_back(child);
+				}
+				previous = std::exchange(board, children[gen() % children.size()]);
+			}
+			ans.push_back(board);
+		}
+		return ans;
+	}
+
+	std::vector<board_t<4>> load_15puzzles(std::string const& path)
+	{
+		std::ifstream is{ path };
+		if (!is) throw std::runtime_error("cannot open " + path);
+		std::vector<board_t<4>> ans;
+		for (std::string line; std::getline(is, line);)
+		{
+			if (line.empty() || '#' == line.front()) continue;
+			std::istringstream tokens{ line };
+			std::array<int, 16> tiles;
+			for (auto& tile : tiles)
+			{
+				tokens >> tile;
+			}
+			//board_t only asserts its tiles, and an unsolvable start searches half the space
+			auto sorted = tiles;
+			std::ranges::sort(sorted);
+			if (!tokens || !std::ranges::equal(sorted, std::views::iota(0, 16))) throw std::runtime_error("malformed instance in " + path);
+			std::array<std::uint8_t, 16> cells;
+			std::ranges::transform(tiles, cells.begin(), [](int const tile) { return static_cast<std::uint8_t>(tile); });
+			board_t<4> const board{ cells };
+			if (!board.solvable()) throw std::runtime_error("malformed instance in " + path);
+			ans.push_back(board);
+		}
+		return ans;
+	}
+
+	void run_queens(unsigned const thread_count)
+	{
+		reset_peak_rss();
+		auto const begin = std::chrono::steady_clock::now();
+		auto const ans = queens::sweep(nullptr, thread_count);
+		std::chrono::duration<double> const wall_time = std::chrono::steady_clock::now() - begin;
+		totals_t totals;
+		totals.instances = ans.climbs;
+		totals.solved = ans.successes;
+		totals.total_length = ans.solutions;
+		totals.expansions = ans.steps;
+		totals.generated = ans.evaluations;
+		report("queens", "hill_climbing", totals, wall_time, ans);
+	}
+
+	template <typename strategy_t>
+	void run_local_search(std::string const& algorithm, strategy_t strategy, std::size_t const instances)
+	{
+		reset_peak_rss();
+		auto const begin = std::chrono::steady_clock::now();
+		auto const ans = queens::local_search_trials(std::move(strategy), instances, seed);
+		std::chrono::duration<double> const wall_time = std::chrono::steady_clock::now() - begin;
+		totals_t totals;
+		totals.instances = ans.trials;
+		totals.solved = ans.solved();
+		totals.total_length = std::accumulate(ans.solution_steps.begin(), ans.solution_steps.end(), std::uint64_t{ 0 });
+		totals.expansions = ans.counters.steps;
+		totals.generated = ans.counters.evaluations;
+		report("localsearch", algorithm, totals, wall_time, ans);
+	}
+
+	void run_local_searches(std::size_t const instances)
+	{
+		queens::local_search_options_t options;
+		options.seed = seed;
+		run_local_search("sideways", queens::sideways_climbing_t{ options }, instances);
+		run_local_search("first_choice", queens::first_choice_climbing_t{ options }, instances);
+		run_local_search("random_restart", queens::random_restart_t<queens::sideways_climbing_t>{ options }, instances);
+		run_local_search("simulated_annealing", queens::simulated_annealing_t<>{ options }, instances);
+	}
+
+	void run_nqueens(std::size_t const instances, unsigned const thread_count)
+	{
+		constexpr std::uint32_t large_n = 1000000U;
+		{
+			reset_peak_rss();
+			auto const begin = std::chrono::steady_clock::now();
+			queens::min_conflicts_options_t options;
+			options.seed = seed;
+			queens::nqueens_t board{ large_n };
+			queens::climb_counters_t ans;
+			queens::min_conflicts_t{ options }(board, ans);
+			std::chrono::duration<double> const wall_time = std::chrono::steady_clock::now() - begin;
+			totals_t totals;
+			totals.instances = 1U;
+			totals.solved = ans.successes;
+			totals.total_length = large_n;
+			totals.expansions = ans.steps;
+			totals.generated = ans.evaluations;
+			report("nqueens", "min_conflicts", totals, wall_time, ans);
+		}
+		{
+			reset_peak_rss();
+			auto const begin = std::chrono::steady_clock::now();
+			queens::min_conflicts_options_t options;
+			options.seed = seed;
+			auto const last = static_cast<std::uint32_t>(instances + 3U);
+			auto const ans = queens::min_conflicts_batch(4U, last, options, thread_count);
+			std::chrono::duration<double> const wall_time = std::chrono::steady_clock::now() - begin;
+			totals_t totals;
+			totals.instances = instances;
+			totals.solved = ans.successes;
+			totals.total_length = (4U + last) * instances / 2U;
+			totals.expansions = ans.steps;
+			totals.generated = ans.evaluations;
+			report("nqueens", "min_conflicts_batch", totals, wall_time, ans);
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	std::vector<std::string> suites, algorithms, pdb_paths;
+	std::size_t instances = 100;
+	std::size_t max_nodes = std::size_t{ 1 } << 22;
+	anytime_options_t anytime;
+	unsigned thread_count = std::max(1U, std::thread::hardware_concurrency());
+	std::string korf100;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string const arg = argv[i];
+		if ("--suite" == arg && i + 1 < argc) suites.push_back(argv[++i]);
+		else if ("--algorithm" == arg && i + 1 < argc) algorithms.push_back(argv[++i]);
+		else if ("--instances" == arg && i + 1 < argc) instances = std::strtoull(argv[++i], nullptr, 10);
+		else if ("--korf100" == arg && i + 1 < argc) korf100 = argv[++i];
+		else if ("--pdb" == arg && i + 1 < argc) pdb_paths.push_back(argv[++i]);
+		else if ("--threads" == arg && i + 1 < argc) thread_count = std::max(1, std::atoi(argv[++i]));
+		else if ("--max-nodes" == arg && i + 1 < argc) max_nodes = std::strtoull(argv[++i], nullptr, 10);
+		else if ("--weight" == arg && i + 1 < argc) anytime.initial_weight = std::atof(argv[++i]);
+		else if ("--time-ms" == arg && i + 1 < argc) anytime.time_budget = std::chrono::milliseconds{ std::atoll(argv[++i]) };
+		else
+		{
+			std::cerr << "unknown argument " << arg << '\n';
+			return EXIT_FAILURE;
+		}
+	}
+	if (suites.empty()) suites = { "8puzzle", "15puzzle", "queens" };
+	if (algorithms.empty()) algorithms = { "astar", "idastar", "hdastar" };
+	for (auto const& algorithm : algorithms)
+	{
+		if ("astar" != algorithm && "idastar" != algorithm && "hdastar" != algorithm && "bibfs" != algorithm
+			&& "mm" != algorithm && "smastar" != algorithm && "ara" != algorithm)
+		{
+			std::cerr << "unknown algorithm " << algorithm << '\n';
+			return EXIT_FAILURE;
+		}
+	}
+	//malformed pattern databases and instance files
+	try
+	{
+		std::optional<pattern_database_t<3>> pdb3;
+		std::optional<pattern_database_t<4>> pdb4;
+		for (auto const& path : pdb_paths)
+		{
+			switch (pattern_database_side_size(path))
+			{
+			case 3: pdb3.emplace(path); break;
+			case 4: pdb4.emplace(path); break;
+			default: throw std::runtime_error("unsupported pattern database " + path);
+			}
+		}
+		for (auto const& suite : suites)
+		{
+			if ("8puzzle" == suite)
+			{
+				auto const boards = random_8puzzles(instances);
+				if (pdb3) run_algorithms<3>(suite, algorithms, *pdb3, thread_count, max_nodes, anytime, boards);
+				else run_algorithms<3>(suite, algorithms, manhattan_t{}, thread_count, max_nodes, anytime, boards);
+			}
+			else if ("15puzzle" == suite)
+			{
+				auto const boards = korf100.empty() ? random_walks<4>(instances, 40) : load_15puzzles(korf100);
+				if (pdb4) run_algorithms<4>(suite, algorithms, *pdb4, thread_count, max_nodes, anytime, boards);
+				else run_algorithms<4>(suite, algorithms, manhattan_t{}, thread_count, max_nodes, anytime, boards);
+			}
+			else if ("24puzzle" == suite)
+			{
+				run_algorithms<5>(suite, algorithms, manhattan_t{}, thread_count, max_nodes, anytime, random_walks<5>(instances, 60));
+			}
+			else if ("queens" == suite)
+			{
+				run_queens(thread_count);
+			}
+			else if ("nqueens" == suite)
+			{
+				run_nqueens(instances, thread_count);
+			}
+			else if ("localsearch" == suite)
+			{
+				run_local_searches(instances);
+			}
+			else
+			{
+				std::cerr << "unknown suite " << suite << '\n';
+				return EXIT_FAILURE;
+			}
+		}
+	}
+	catch (std::exception const& e)
+	{
+		std::cerr << e.what() << '\n';
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
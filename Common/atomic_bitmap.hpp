@@ -0,0 +1,39 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//One bit per index, set concurrently: 2 MB for the 2^24 boards of 8-queens where
+//a std::atomic_flag per index takes 16 MB or more.
+class atomic_bitmap_t
+{
+public:
+	explicit atomic_bitmap_t(std::size_t const size)
+		: m_words((size + 63U) / 64U)
+	{
+	}
+	//sets the bit and reports whether it was set before
+	bool test_and_set(std::size_t const index) noexcept
+	{
+		auto const mask = std::uint64_t{ 1 } << (index % 64U);
+		return 0U != (m_words[index / 64U].fetch_or(mask, std::memory_order_relaxed) & mask);
+	}
+	bool test(std::size_t const index) const noexcept
+	{
+		return 0U != (m_words[index / 64U].load(std::memory_order_relaxed) & (std::uint64_t{ 1 } << (index % 64U)));
+	}
+	std::size_t count() const noexcept
+	{
+		std::size_t ans = 0;
+		for (auto const& word : m_words)
+		{
+			ans += static_cast<std::size_t>(std::popcount(word.load(std::memory_order_relaxed)));
+		}
+		return ans;
+	}
+private:
+	std::vector<std::atomic<std::uint64_t>> m_words;
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+//Records produced by many threads and written out by one background thread. Every
+//producer fills a batch_buffer_t of its own and hands the full batch over by pushing
+//it on a lock free stack; the writer thread takes the whole stack at once. Producers
+//never wait for each other or for the output, however slow it is. Batches of one
+//producer are written in the order they were handed over.
+template <typename record_t>
+class batch_writer_t
+{
+public:
+	using sink_t = std::function<void(std::vector<record_t> const&)>;
+	//sink is called on the writer thread only
+	explicit batch_writer_t(sink_t sink)
+		: m_sink{ std::move(sink) }, m_thread{ [this]() { drain(); } }
+	{
+	}
+	batch_writer_t(batch_writer_t const&) = delete;
+	batch_writer_t& operator=(batch_writer_t const&) = delete;
+	//writes what is left once every producer is done
+	~batch_writer_t()
+	{
+		push(new batch_t{ {}, nullptr, true });
+	}
+	void submit(std::vector<record_t>&& records)
+	{
+		if (!records.empty()) push(new batch_t{ std::move(records), nullptr, false });
+	}
+private:
+	struct batch_t
+	{
+		std::vector<record_t> records;
+		batch_t* next;
+		//pushed by the destructor after every other batch
+		bool last;
+	};
+	void push(batch_t* const batch)
+	{
+		batch->next = m_head.load(std::memory_order_relaxed);
+		while (!m_head.compare_exchange_weak(batch->next, batch, std::memory_order_release, std::memory_order_relaxed))
+		{
+		}
+		m_head.notify_one();
+	}
+	void drain()
+	{
+		for (bool last = false; !last;)
+		{
+			m_head.wait(nullptr, std::memory_order_acquire);
+			//the stack holds the newest batch first
+			batch_t* batches = nullptr;
+			for (auto* batch = m_head.exchange(nullptr, std::memory_order_acquire); nullptr != batch;)
+			{
+				batches = std::exchange(batch, std::exchange(batch->next, batches));
+			}
+			while (nullptr != batches)
+			{
+				m_sink(batches->records);
+				last = batches->last;
+				delete std::exchange(batches, batches->next);
+			}
+		}
+	}
+	sink_t m_sink;
+	std::atomic<batch_t*> m_head{ nullptr };
+	std::jthread m_thread;
+};
+
+//one producer's records, handed to the writer every capacity records and when destroyed
+template <typename record_t>
+class batch_buffer_t
+{
+public:
+	explicit batch_buffer_t(batch_writer_t<record_t>& writer, std::size_t const capacity = 4096U)
+		: m_writer{ writer }, m_capacity{ capacity }
+	{
+		m_records.reserve(m_capacity);
+	}
+	batch_buffer_t(batch_buffer_t const&) = delete;
+	batch_buffer_t& operator=(batch_buffer_t const&) = delete;
+	~batch_buffer_t()
+	{
+		m_writer.submit(std::move(m_records));
+	}
+	void push_back(record_t const& record)
+	{
+		m_records.push_back(record);
+		if (m_records.size() == m_capacity)
+		{
+			m_writer.submit(std::exchange(m_records, {}));
+			m_records.reserve(m_capacity);
+		}
+	}
+private:
+	batch_writer_t<record_t>& m_writer;
+	std::size_t m_capacity;
+	std::vector<record_t> m_records;
+};
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+//Counters are plain members owned by a single thread. Parallel code keeps one set
+//per worker and merge()s them once the workers are done, so the hot path never
+//touches an atomic. write_json() emits one JSON object.
+
+//number of events per small integer key, e.g. expansions per depth
+class histogram_t
+{
+public:
+	void add(std::size_t const key, std::uint64_t const count = 1U)
+	{
+		if (key >= m_counts.size()) m_counts.resize(key + 1U);
+		m_counts[key] += count;
+	}
+	void merge(histogram_t const& other)
+	{
+		if (other.m_counts.size() > m_counts.size()) m_counts.resize(other.m_counts.size());
+		for (std::size_t i = 0; i < other.m_counts.size(); i++)
+		{
+			m_counts[i] += other.m_counts[i];
+		}
+	}
+	std::vector<std::uint64_t> const& counts() const noexcept
+	{
+		return m_counts;
+	}
+	void write_json(std::ostream& os) const
+	{
+		os << '[';
+		for (std::size_t i = 0; i < m_counts.size(); i++)
+		{
+			os << (0U == i ? "" : ",") << m_counts[i];
+		}
+		os << ']';
+	}
+private:
+	std::vector<std::uint64_t> m_counts;
+};
+
+//wall time per named phase; a phase entered again accumulates, names are string literals
+class phase_timings_t
+{
+public:
+	using clock_t = std::chrono::steady_clock;
+	void add(char const* name, clock_t::duration const elapsed)
+	{
+		auto const it = std::ranges::find_if(m_phases, [name](auto const& phase) { return std::string_view{ phase.first } == name; });
+		if (m_phases.end() == it) m_phases.emplace_back(name, elapsed);
+		else it->second += elapsed;
+	}
+	void merge(phase_timings_t const& other)
+	{
+		for (auto const& [name, elapsed] : other.m_phases)
+		{
+			add(name, elapsed);
+		}
+	}
+	//seconds per phase
+	void write_json(std::ostream& os) const
+	{
+		os << '{';
+		for (std::size_t i = 0; i < m_phases.size(); i++)
+		{
+			os << (0U == i ? "" : ",") << '"' << m_phases[i].first << "\":"
+				<< std::chrono::duration<double>(m_phases[i].second).count();
+		}
+		os << '}';
+	}
+private:
+	std::vector<std::pair<char const*, clock_t::duration>> m_phases;
+};
+
+//charges the time until it goes out of scope to one phase
+class scoped_phase_t
+{
+public:
+	scoped_phase_t(phase_timings_t& timings, char const* name) noexcept
+		: m_timings{ timings }, m_name{ name }, m_begin{ phase_timings_t::clock_t::now() }
+	{
+	}
+	scoped_phase_t(scoped_phase_t const&) = delete;
+	scoped_phase_t& operator=(scoped_phase_t const&) = delete;
+	~scoped_phase_t()
+	{
+		m_timings.add(m_name, phase_timings_t::clock_t::now() - m_begin);
+	}
+private:
+	phase_timings_t& m_timings;
+	char const* m_name;
+	phase_timings_t::clock_t::time_point m_begin;
+};
+
+struct search_counters_t
+{
+	std::uint64_t expansions = 0;
+	//every node created, the root included
+	std::uint64_t generations = 0;
+	//generated nodes dropped because the closed list already held them
+	std::uint64_t duplicates = 0;
+	std::uint64_t peak_open = 0;
+	//closed list occupancy when the search stopped
+	double load_factor = 0.0;
+	histogram_t expansions_by_depth;
+	phase_timings_t phases;
+
+	void expand(std::uint16_t const depth)
+	{
+		expansions++;
+		expansions_by_depth.add(depth);
+	}
+	void open_size(std::size_t const size) noexcept
+	{
+		peak_open = std::max<std::uint64_t>(peak_open, size);
+	}
+	//sums the counts; peaks and load factors keep the largest
+	void merge(search_counters_t const& other)
+	{
+		expansions += other.expansions;
+		generations += other.generations;
+		duplicates += other.duplicates;
+		peak_open = std::max(peak_open, other.peak_open);
+		load_factor = std::max(load_factor, other.load_factor);
+		expansions_by_depth.merge(other.expansions_by_depth);
+		phases.merge(other.phases);
+	}
+	void write_json(std::ostream& os) const
+	{
+		os << "{\"expansions\":" << expansions
+			<< ",\"generations\":" << generations
+			<< ",\"duplicates\":" << duplicates
+			<< ",\"peak_open\":" << peak_open
+			<< ",\"load_factor\":" << load_factor
+			<< ",\"expansions_by_depth\":";
+		expansions_by_depth.write_json(os);
+		os << ",\"phases\":";
+		phases.write_json(os);
+		os << '}';
+	}
+};
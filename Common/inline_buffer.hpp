@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+//At most capacity values stored in place, for successor lists whose length the
+//problem bounds: filling one never allocates, and the children sit next to each
+//other for callers that evaluate them as a batch. Only for trivially copyable
+//values, so slots past size() are never constructed or destroyed.
+template <typename value_t, std::size_t capacity>
+class inline_buffer_t
+{
+	static_assert(std::is_trivially_copyable_v<value_t> && std::is_trivially_destructible_v<value_t>);
+public:
+	constexpr inline_buffer_t() noexcept
+	{
+	}
+	constexpr void push_back(value_t const& value) noexcept
+	{
+		assert(m_size < capacity);
+		std::construct_at(m_values + m_size++, value);
+	}
+	constexpr void clear() noexcept
+	{
+		m_size = 0U;
+	}
+	constexpr value_t const& operator[](std::size_t const i) const noexcept
+	{
+		assert(i < m_size);
+		return m_values[i];
+	}
+	constexpr value_t const* data() const noexcept
+	{
+		return m_values;
+	}
+	constexpr value_t const* begin() const noexcept
+	{
+		return m_values;
+	}
+	constexpr value_t const* end() const noexcept
+	{
+		return m_values + m_size;
+	}
+	constexpr std::size_t size() const noexcept
+	{
+		return m_size;
+	}
+	constexpr bool empty() const noexcept
+	{
+		return 0U == m_size;
+	}
+	constexpr static std::size_t max_size() noexcept
+	{
+		return capacity;
+	}
+private:
+	union
+	{
+		value_t m_values[capacity];
+	};
+	std::size_t m_size = 0U;
+};
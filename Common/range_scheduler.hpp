@@ -0,0 +1,79 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+//Work stealing over an index range. Every worker starts with an equal share and
+//takes small chunks off the front of it; a worker whose share is used up steals
+//the back half of another worker's share and carries on with that. Both ends of a
+//share sit in one 64 bit word, so taking and stealing are a single compare and
+//swap each and no lock is ever held.
+class range_scheduler_t
+{
+public:
+	using range_t = std::pair<std::uint32_t, std::uint32_t>;
+	range_scheduler_t(std::uint32_t const first, std::uint32_t const last, unsigned const worker_count, std::uint32_t const chunk)
+		: m_shares(std::max(worker_count, 1U)), m_chunk{ std::max(chunk, 1U) }
+	{
+		auto const size = static_cast<std::uint64_t>(last - first);
+		for (std::size_t i = 0; i < m_shares.size(); i++)
+		{
+			auto const begin = first + static_cast<std::uint32_t>(size * i / m_shares.size());
+			auto const end = first + static_cast<std::uint32_t>(size * (i + 1U) / m_shares.size());
+			m_shares[i].range.store(pack(begin, end), std::memory_order_relaxed);
+		}
+	}
+	//the next chunk for worker, none once every share is used up
+	std::optional<range_t> next(unsigned const worker)
+	{
+		auto& own = m_shares[worker].range;
+		for (auto range = own.load(std::memory_order_relaxed); begin(range) < end(range);)
+		{
+			auto const taken = std::min(m_chunk, end(range) - begin(range));
+			if (own.compare_exchange_weak(range, pack(begin(range) + taken, end(range)), std::memory_order_relaxed))
+			{
+				return range_t{ begin(range), begin(range) + taken };
+			}
+		}
+		for (std::size_t i = 1; i < m_shares.size(); i++)
+		{
+			auto& victim = m_shares[(worker + i) % m_shares.size()].range;
+			for (auto range = victim.load(std::memory_order_relaxed); begin(range) < end(range);)
+			{
+				auto const middle = end(range) - (end(range) - begin(range) + 1U) / 2U;
+				if (victim.compare_exchange_weak(range, pack(begin(range), middle), std::memory_order_relaxed))
+				{
+					//nobody steals from an empty share, so the stolen half can be stored as is
+					auto const taken = std::min(m_chunk, end(range) - middle);
+					own.store(pack(middle + taken, end(range)), std::memory_order_relaxed);
+					return range_t{ middle, middle + taken };
+				}
+			}
+		}
+		return std::nullopt;
+	}
+private:
+	static std::uint64_t pack(std::uint32_t const begin, std::uint32_t const end) noexcept
+	{
+		return static_cast<std::uint64_t>(begin) << 32 | end;
+	}
+	static std::uint32_t begin(std::uint64_t const range) noexcept
+	{
+		return static_cast<std::uint32_t>(range >> 32);
+	}
+	static std::uint32_t end(std::uint64_t const range) noexcept
+	{
+		return static_cast<std::uint32_t>(range);
+	}
+	//a cache line per share, so workers taking chunks do not slow each other down
+	struct alignas(64) share_t
+	{
+		std::atomic<std::uint64_t> range;
+	};
+	std::vector<share_t> m_shares;
+	std::uint32_t m_chunk;
+};
@@ -2,375 +2,243 @@
 //
 #include <algorithm>
 #include <array>
-#include <bit>
-#include <bitset>
-#include <cassert>
-#include <cmath>
-#include <concepts>
+#include <chrono>
 #include <cstdint>
-#include <experimental/generator>
-#include <initializer_list>
-#include <iomanip>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
 #include <iostream>
-#include <queue>
+#include <optional>
 #include <random>
-#include <ranges>
-#include <unordered_set>
+#include <string>
+
+#include "npuzzle.hpp"
+#include "npuzzle_anytime.hpp"
+#include "npuzzle_batch.hpp"
+#include "npuzzle_bidirectional.hpp"
+#include "npuzzle_bounded.hpp"
+#include "npuzzle_external.hpp"
+#include "npuzzle_generator.hpp"
+#include "npuzzle_heuristic.hpp"
+#include "npuzzle_parallel.hpp"
+#include "npuzzle_solver.hpp"
 
 //#include <boost/heap/fibonacci_heap.hpp>
 
-template <std::uint8_t side_size>
-struct board_t
+//npuzzle --batch <instances file or -> [--algorithm astar|idastar|smastar|ara] [--threads n] [--pdb file]...
+//               [--max-nodes n] [--memory-mb n] [--weight w] [--time-ms n]
+int batch_main(int argc, char* argv[])
 {
-	constexpr static std::uint8_t board_size = side_size * side_size;
-	constexpr static std::uint8_t cell_width = std::bit_width(board_size - 1U);
-	using cell_t = std::bitset<cell_width>;
-	using cells_t = std::bitset<board_size* cell_width>;
-	cells_t m_cells;
-	board_t const* parent;
-	std::uint16_t depth, cost;
-
-	template<std::ranges::bidirectional_range Rng>
-	constexpr board_t(std::from_range_t, Rng&& r) noexcept
-		: m_cells{}, parent{ nullptr }, depth{}, cost{}
+	batch_options_t options;
+	std::string input = "-";
+	for (int i = 1; i < argc; i++)
 	{
-		assert(r.size() == board_size);
-		std::unordered_set<cell_t> unique_set;
-		for (auto cell : std::ranges::reverse_view(r))
+		std::string const arg = argv[i];
+		if ("--batch" == arg && i + 1 < argc) input = argv[++i];
+		else if ("--algorithm" == arg && i + 1 < argc) options.algorithm = argv[++i];
+		else if ("--threads" == arg && i + 1 < argc) options.thread_count = std::max(1, std::atoi(argv[++i]));
+		else if ("--pdb" == arg && i + 1 < argc) options.pdb_paths.push_back(argv[++i]);
+		else if ("--max-nodes" == arg && i + 1 < argc) options.max_nodes = std::strtoull(argv[++i], nullptr, 10);
+		else if ("--memory-mb" == arg && i + 1 < argc) options.memory_budget = std::strtoull(argv[++i], nullptr, 10) << 20;
+		else if ("--weight" == arg && i + 1 < argc) options.anytime.initial_weight = std::atof(argv[++i]);
+		else if ("--time-ms" == arg && i + 1 < argc) options.anytime.time_budget = std::chrono::milliseconds{ std::atoll(argv[++i]) };
+		else
 		{
-			assert(unique_set.insert(cell).second);
-			m_cells <<= cell_width;
-			m_cells |= cells_t{ cell.to_ulong() };
+			std::cerr << "unknown argument " << arg << '\n';
+			return EXIT_FAILURE;
 		}
 	}
-	constexpr board_t(std::initializer_list<cell_t> cells) noexcept
-		: board_t(std::from_range_t{}, cells)
-	{
-	}
-	constexpr board_t(std::array<cell_t, board_size> cells) noexcept
-		: board_t(std::from_range_t{}, cells)
+	if ("astar" != options.algorithm && "idastar" != options.algorithm && "smastar" != options.algorithm && "ara" != options.algorithm)
 	{
+		std::cerr << "unknown algorithm " << options.algorithm << '\n';
+		return EXIT_FAILURE;
 	}
-	constexpr board_t swap_empty(std::uint8_t i, std::uint8_t j) const noexcept
+	std::ios::sync_with_stdio(false);
+	//reading the next instance must not flush std::cout behind the output lock
+	std::cin.tie(nullptr);
+	//pattern databases that fail to load, threads that fail to start
+	try
 	{
-		auto ans = *this;
-		--i;
-		--j;
-		assert(i < board_size);
-		assert(j < board_size);
-		for (std::uint8_t k = 0; k < cell_width; k++)
+		if ("-" == input)
 		{
-			ans.m_cells.set(i * cell_width + k, m_cells[j * cell_width + k]);
-			ans.m_cells.set(j * cell_width + k, m_cells[i * cell_width + k]);
+			return run_batch(std::cin, std::cout, options);
 		}
-		if (!(this->parity() == ans.parity()))
+		std::ifstream is{ input };
+		if (!is)
 		{
-			std::cout << *this << '\n';
-			std::cout << ans << '\n';
+			std::cerr << "cannot open " << input << '\n';
+			return EXIT_FAILURE;
 		}
-		assert(this->parity() == ans.parity());
-		ans.parent = this;
-		ans.depth = depth + 1ui16;
-		ans.cost = depth + 1ui16 + heuristic();
-		return ans;
-	}
-	constexpr bool operator == (board_t const& other) const noexcept
-	{
-		return m_cells == other.m_cells;
+		return run_batch(is, std::cout, options);
 	}
-	constexpr bool operator < (board_t const& other) const noexcept
+	catch (std::exception const& e)
 	{
-		return cost < other.cost;
+		std::cerr << e.what() << '\n';
+		return EXIT_FAILURE;
 	}
-	friend std::ostream& operator<<(std::ostream& os, board_t<side_size> arg)
+}
+
+//npuzzle --enumerate <3|4> [--work-dir dir] [--memory-mb n] [--keep-layers]
+//prints "depth count" for every layer around the goal
+int enumerate_main(int argc, char* argv[])
+{
+	external_bfs_options_t options;
+	int side = 0;
+	for (int i = 1; i < argc; i++)
 	{
-		for (std::uint8_t row = 0; row < side_size; row++)
+		std::string const arg = argv[i];
+		if ("--enumerate" == arg && i + 1 < argc) side = std::atoi(argv[++i]);
+		else if ("--work-dir" == arg && i + 1 < argc) options.work_dir = argv[++i];
+		else if ("--memory-mb" == arg && i + 1 < argc) options.memory_budget = std::strtoull(argv[++i], nullptr, 10) << 20;
+		else if ("--keep-layers" == arg) options.keep_layers = true;
+		else
 		{
-			for (std::uint8_t col = 0; col < side_size; col++)
-			{
-				auto const shift = cell_width * (row * side_size + col);
-				os << std::setw(2)<< ((arg.m_cells >> shift).to_ullong() & 0x0f) << ' ';
-			}
-			os << '\n';
+			std::cerr << "unknown argument " << arg << '\n';
+			return EXIT_FAILURE;
 		}
-		return os;
 	}
-	std::experimental::generator<board_t<side_size>> neighbors() const
+	switch (side)
 	{
-		auto const empty_idx = empty_cell_index();
-		if (!is_left_border(empty_idx)) co_yield swap_empty(empty_idx, empty_idx - 1ui8);
-		if (!is_right_border(empty_idx)) co_yield swap_empty(empty_idx, empty_idx + 1ui8);
-		if (!is_top_border(empty_idx)) co_yield swap_empty(empty_idx, empty_idx - side_size);
-		if (!is_bottom_border(empty_idx)) co_yield swap_empty(empty_idx, empty_idx + side_size);
+	case 3:
+		external_bfs_t<3>{ options }({ 0,1,2,3,4,5,6,7,8 }, std::cout);
+		return EXIT_SUCCESS;
+	case 4:
+		external_bfs_t<4>{ options }({ 0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15 }, std::cout);
+		return EXIT_SUCCESS;
+	default:
+		std::cerr << "unsupported side " << side << '\n';
+		return EXIT_FAILURE;
 	}
-	constexpr std::uint8_t heuristic() const noexcept
+}
+
+//npuzzle --generate <count> [--side 3|4|5] [--walk length] [--seed s] [--output file]
+//writes count uniformly random solvable boards, or random walks of length moves from the
+//goal, in the --batch format
+int generate_main(int argc, char* argv[])
+{
+	std::uint64_t count = 0;
+	int side = 4;
+	std::optional<std::size_t> walk;
+	std::uint64_t seed = std::random_device{}();
+	std::string output;
+	for (int i = 1; i < argc; i++)
 	{
-		std::uint8_t ans = 0;
-		for (std::uint8_t current_pos = 0ui8; current_pos < board_size; current_pos++)
+		std::string const arg = argv[i];
+		if ("--generate" == arg && i + 1 < argc) count = std::strtoull(argv[++i], nullptr, 10);
+		else if ("--side" == arg && i + 1 < argc) side = std::atoi(argv[++i]);
+		else if ("--walk" == arg && i + 1 < argc) walk = std::strtoull(argv[++i], nullptr, 10);
+		else if ("--seed" == arg && i + 1 < argc) seed = std::strtoull(argv[++i], nullptr, 10);
+		else if ("--output" == arg && i + 1 < argc) output = argv[++i];
+		else
 		{
-			auto const shift = cell_width * current_pos;
-			std::uint8_t const desired_pos = (m_cells >> shift).to_ullong() & 0x0f;
-			//if (0ui8 == desired_pos) continue;
-			if (current_pos != desired_pos)
-			{
-				auto const current_dv = std::div(current_pos, side_size);
-				auto const right_dv = std::div(desired_pos, side_size);
-				ans += std::abs(current_dv.quot - right_dv.quot);
-				ans += std::abs(current_dv.rem - right_dv.rem);
-			}
+			std::cerr << "unknown argument " << arg << '\n';
+			return EXIT_FAILURE;
 		}
-		return ans;
 	}
-	constexpr bool parity() const noexcept
+	std::ofstream file;
+	if (!output.empty())
 	{
-		int ans = 0;
-		std::uint8_t const empty_idx = empty_cell_index() - 1ui8;
-		for (std::uint8_t i = 0; i < board_size; i++)
+		file.open(output);
+		if (!file)
 		{
-			if (i == empty_idx) continue;
-			auto const shift = cell_width * i;
-			auto const lhs = ((m_cells >> shift).to_ullong() & 0x0f);
-			for (std::uint8_t j = i + 1ui8; j < board_size; j++)
-			{
-				if (j == empty_idx) continue;
-				auto const shift = cell_width * j;
-				auto const rhs = ((m_cells >> shift).to_ullong() & 0x0f);
-				if (lhs > rhs)
-				{
-					ans++;
-				}
-			}
+			std::cerr << "cannot open " << output << '\n';
+			return EXIT_FAILURE;
 		}
-		return ans & 1;
 	}
-private:
-	//1   2  3  4
-	//5   6  7  8
-	//9  10 11 12
-	//13 14 15 16
-	constexpr std::uint8_t empty_cell_index() const noexcept
-	{
-		std::uint8_t ans = 1ui8;
-		cells_t mask{ 0x0f };
-		for (; ans <= board_size; ++ans)
+	std::ios::sync_with_stdio(false);
+	auto& os = output.empty() ? std::cout : file;
+	auto const generate = [&os, count, walk, seed]<std::uint8_t side_size>()
 		{
-			if (mask == ((m_cells ^ mask) & mask))break;
-			mask <<= cell_width;
-		}
-		assert(ans <= board_size);
-		return ans;
-	}
-	constexpr bool is_right_border(std::uint8_t const empty_idx) const noexcept
-	{
-		return 0 == empty_idx % side_size;
-	}
-	constexpr bool is_left_border(std::uint8_t const empty_idx) const noexcept
-	{
-		return 1ui8 == empty_idx % side_size;
-	}
-	constexpr bool is_top_border(std::uint8_t const empty_idx) const noexcept
-	{
-		return empty_idx <= side_size;
-	}
-	constexpr bool is_bottom_border(std::uint8_t const empty_idx) const noexcept
-	{
-		return (empty_idx + side_size) > (side_size * side_size);
-	}
-	friend void test();
-};
-
-template<std::uint8_t side_size>
-struct std::hash<board_t<side_size>>
-{
-	constexpr std::size_t operator()(const board_t<side_size>& arg) const noexcept
-	{
-		return std::hash<typename board_t<side_size>::cells_t>{}(arg.m_cells);
-	}
-};
-
-template <std::uint8_t side_size>
-bool astar(board_t<side_size> const start, board_t<side_size> const goal)
-{
-	using history_t = std::unordered_set<board_t<side_size>>;
-	history_t explored_nodes;
-	std::uint16_t max_depth = 0ui16;
-	auto cmp = [](auto lhs, auto rhs) noexcept -> bool
-		{
-			return lhs->cost > rhs->cost;
+			instance_generator_t<side_size> generator{ seed };
+			if (walk) write_instances<side_size>(os, count, [&generator, length = *walk]() { return generator.random_walk(length); });
+			else write_instances<side_size>(os, count, [&generator]() { return generator.random_solvable(); });
 		};
-	std::priority_queue<typename history_t::const_iterator,
-		std::deque<typename history_t::const_iterator>, decltype(cmp)> frontier{cmp};
-	//boost::heap::fibonacci_heap<typename history_t::const_iterator, boost::heap::compare<decltype(cmp)>> frontier(cmp);
-	frontier.push(explored_nodes.emplace(start).first);
-	while (!frontier.empty())
+	switch (side)
 	{
-		auto const parent = frontier.top();
-		frontier.pop();
-		if (*parent == goal)
-		{
-			std::cout << "explored_nodes   " << explored_nodes.size() << '\n';
-			std::cout << "nodes_expanded   " << explored_nodes.size() - frontier.size() << '\n';
-			std::cout << "depth            " << parent->depth << '\n';
-			std::cout << "max depth        " << max_depth << '\n';
-			std::cout << "cost             " << parent->cost << '\n';
-			return true;
-		}
-		for (auto const& neighbor : parent->neighbors())
-		{
-			if (auto [it, inserted] = explored_nodes.emplace(neighbor); inserted)
-			{
-				frontier.push(it);
-				max_depth = std::max(max_depth, neighbor.depth);
-			}
-		}
+	case 3:
+		generate.template operator()<3>();
+		break;
+	case 4:
+		generate.template operator()<4>();
+		break;
+	case 5:
+		generate.template operator()<5>();
+		break;
+	default:
+		std::cerr << "unsupported side " << side << '\n';
+		return EXIT_FAILURE;
 	}
-	return false;
+	return os ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
-template <std::uint8_t side_size>
-bool bfs(board_t<side_size> const start, board_t<side_size> const goal)
+int main(int argc, char* argv[])
 {
-	using history_t = std::unordered_set<board_t<side_size>>;
-	history_t explored_nodes;
-	std::uint16_t max_depth = 0ui16;
-	std::deque<typename history_t::const_iterator> frontier;
-	frontier.push_back(explored_nodes.emplace(start).first);
-	while (!frontier.empty())
+	if (argc > 1 && std::string{ "--batch" } == argv[1])
 	{
-		auto const parent = frontier.front();
-		frontier.pop_front();
-		explored_nodes.emplace(*parent);
-		if (*parent == goal)
-		{
-			std::cout << "explored_nodes   " << explored_nodes.size() << '\n';
-			std::cout << "nodes_expanded   " << explored_nodes.size() - frontier.size() << '\n';
-			std::cout << "depth            " << parent->depth << '\n';
-			std::cout << "max depth        " << max_depth << '\n';
-			std::cout << "cost             " << parent->cost << '\n';
-			return true;
-		}
-		for (auto const& neighbor : parent->neighbors())
-		{
-			if (auto [it, inserted] = explored_nodes.emplace(neighbor); inserted)
-			{
-				frontier.push_back(it);
-				max_depth = std::max(max_depth, neighbor.depth);
-			}
-		}
+		return batch_main(argc, argv);
 	}
-	return false;
-}
-
-template <std::uint8_t side_size>
-bool dfs(board_t<side_size> const start, board_t<side_size> const goal)
-{
-	using history_t = std::unordered_set<board_t<side_size>>;
-	history_t explored_nodes;
-	std::uint16_t max_depth = 0ui16;
-	std::deque<typename history_t::const_iterator> frontier;
-	frontier.push_back(explored_nodes.emplace(start).first);
-	while (!frontier.empty())
+	if (argc > 1 && std::string{ "--enumerate" } == argv[1])
 	{
-		auto const parent = frontier.back();
-		frontier.pop_back();
-		explored_nodes.emplace(*parent);
-		if (*parent == goal)
-		{
-			std::cout << "explored_nodes   " << explored_nodes.size() << '\n';
-			std::cout << "nodes_expanded   " << explored_nodes.size() - frontier.size() << '\n';
-			std::cout << "depth            " << parent->depth << '\n';
-			std::cout << "max depth        " << max_depth << '\n';
-			std::cout << "cost             " << parent->cost << '\n';
-			return true;
-		}
-		for (auto const& neighbor : parent->neighbors())
-		{
-			if (auto [it, inserted] = explored_nodes.emplace(neighbor); inserted)
-			{
-				frontier.push_back(it);
-				max_depth = std::max(max_depth, neighbor.depth);
-			}
-		}
+		return enumerate_main(argc, argv);
 	}
-	return false;
-}
-
-template <std::uint8_t side_size>
-bool dls(board_t<side_size> const start, board_t<side_size> const goal, std::uint16_t limit)
-{
-	using history_t = std::unordered_set<board_t<side_size>>;
-	history_t explored_nodes;
-	std::uint16_t max_depth = 0ui16;
-	std::deque<typename history_t::const_iterator> frontier;
-	frontier.push_back(explored_nodes.emplace(start).first);
-	while (!frontier.empty())
+	if (argc > 1 && std::string{ "--generate" } == argv[1])
 	{
-		auto const parent = frontier.back();
-		frontier.pop_back();
-		explored_nodes.emplace(*parent);
-		if (*parent == goal)
-		{
-			std::cout << "explored_nodes   " << explored_nodes.size() << '\n';
-			std::cout << "nodes_expanded   " << explored_nodes.size() - frontier.size() << '\n';
-			std::cout << "depth            " << parent->depth << '\n';
-			std::cout << "max depth        " << max_depth << '\n';
-			std::cout << "cost             " << parent->cost << '\n';
-			std::cout << "limit            " << limit << '\n';
-			return true;
-		}
-		if (parent->depth >= limit) continue;
-		for (auto const& neighbor : parent->neighbors())
-		{
-			if (auto [it, inserted] = explored_nodes.emplace(neighbor); inserted)
-			{
-				frontier.push_back(it);
-				max_depth = std::max(max_depth, neighbor.depth);
-			}
-		}
+		return generate_main(argc, argv);
 	}
-	return false;
-}
-
-template <std::uint8_t side_size>
-bool iddfs(board_t<side_size> const start, board_t<side_size> const goal)
-{
-	for (std::uint16_t i = 0; ;i++)
+	std::optional<pattern_database_t<3>> pdb;
+	if (argc > 1)
 	{
-		if (dls<side_size>(start, goal, i))
-		{
-			return true;
-		}
+		pdb.emplace(argv[1]);
 	}
-	return false;
-}
-
-int main()
-{
-	std::random_device rd;
-	std::mt19937 gen{ rd() };
-	std::array<std::bitset<4>, 9> init{ 0,1,2,3,4,5,6,7,8 };
+	instance_generator_t<3> generator{ std::random_device{}() };
 	//std::array<std::uint32_t, 90> stats{0};
 	for (size_t i = 0; i < 10; i++)
 	{
-		do
-		{
-			std::ranges::shuffle(init, gen);
-		} while (board_t<3>{init}.parity());
-		board_t<3> const start{ std::from_range, init };
+		auto const start = generator.random_solvable();
 		std::cout << start << std::boolalpha;
-		auto ans = astar<3>(
+		auto ans = pdb ? astar<3>(
+			start,
+			{ 0,1,2,3,4,5,6,7,8 }, *pdb) : astar<3>(
 			start,
 			{ 0,1,2,3,4,5,6,7,8});
 		std::cout << ans << '\n';
-		ans = bfs<3>(
+		ans = pdb ? idastar<3>(
+			start,
+			{ 0,1,2,3,4,5,6,7,8 }, *pdb) : idastar<3>(
+			start,
+			{ 0,1,2,3,4,5,6,7,8 });
+		std::cout << ans << '\n';
+		ans = pdb ? hdastar<3>(
+			start,
+			{ 0,1,2,3,4,5,6,7,8 }, *pdb) : hdastar<3>(
+			start,
+			{ 0,1,2,3,4,5,6,7,8 });
+		std::cout << ans << '\n';
+		ans = bfs<3, dense_history_t<3>>(
+			start,
+			{ 0,1,2,3,4,5,6,7,8 });
+		std::cout << ans << '\n';
+		ans = smastar<3>(
+			start,
+			{ 0,1,2,3,4,5,6,7,8 }, manhattan_t{}, 4096U);
+		std::cout << ans << '\n';
+		ans = ara<3>(
+			start,
+			{ 0,1,2,3,4,5,6,7,8 });
+		std::cout << ans << '\n';
+		ans = bibfs<3>(
+			start,
+			{ 0,1,2,3,4,5,6,7,8 });
+		std::cout << ans << '\n';
+		ans = mm<3>(
 			start,
 			{ 0,1,2,3,4,5,6,7,8 });
 		std::cout << ans << '\n';
-		ans = dfs<3>(
+		ans = dfs<3, dense_history_t<3>>(
 			start,
 			{ 0,1,2,3,4,5,6,7,8 });
 		std::cout << ans << '\n';
-		ans = iddfs<3>(
+		ans = iddfs<3, dense_history_t<3>>(
 			start,
 			{ 0,1,2,3,4,5,6,7,8 });
 		std::cout << ans << '\n';
@@ -2,114 +2,240 @@
 
 #include <array>
 #include <bit>
-#include <bitset>
 #include <cassert>
 #include <concepts>
 #include <cstdint>
-#include <cstdlib>
-#include <experimental/generator>
 #include <initializer_list>
 #include <iomanip>
-#include <iosfwd>
+#include <ostream>
 #include <ranges>
-#include <stack>
-#include <unordered_set>
+#include <span>
+#include <type_traits>
+
+#include "../Common/inline_buffer.hpp"
+
+//direction the blank travels; opposite moves differ in the lowest bit
+enum class move_t : std::uint8_t
+{
+	left,
+	right,
+	up,
+	down,
+};
+
+constexpr move_t opposite(move_t const arg) noexcept
+{
+	return static_cast<move_t>(static_cast<std::uint8_t>(arg) ^ 1U);
+}
+
+inline std::ostream& operator<<(std::ostream& os, move_t const arg)
+{
+	return os << "LRUD"[static_cast<std::uint8_t>(arg)];
+}
 
 template <std::uint8_t side_size>
 struct board_t
 {
 	constexpr static std::uint8_t board_size = side_size * side_size;
 	constexpr static std::uint8_t cell_width = std::bit_width(board_size - 1U);
-	using cell_t = std::bitset<cell_width>;
-	using cells_t = std::bitset<board_size* cell_width>;
-	std::uint8_t m_empty_cell_index;
+	constexpr static std::uint64_t cell_mask = (1ULL << cell_width) - 1U;
+	constexpr static std::uint8_t cells_per_word = 64 / cell_width;
+	constexpr static std::uint8_t word_count = (board_size + cells_per_word - 1) / cells_per_word;
+	using cell_t = std::uint8_t;
+	//up to 4x4 all cells share one word; wider boards spread whole cells over several words
+	using cells_t = std::conditional_t<1 == word_count, std::uint64_t, std::array<std::uint64_t, word_count>>;
 	cells_t m_cells;
+	std::uint8_t m_empty_cell_index;
+	//a blank has at most 4 neighbors
+	using successors_t = inline_buffer_t<board_t, 4>;
+
+	//legal blank targets per 0 based blank position, in left, right, up, down order
+	struct moves_t
+	{
+		std::uint8_t count;
+		std::array<std::uint8_t, 4> targets;
+	};
+	using move_table_t = std::array<moves_t, board_size>;
+	using manhattan_table_t = std::array<std::array<std::uint8_t, board_size>, board_size>;
+	using delta_table_t = std::array<std::array<std::array<std::int8_t, 4>, board_size>, board_size>;
+	constexpr static move_table_t move_table = []()
+		{
+			move_table_t ans{};
+			for (std::uint8_t pos = 0; pos < board_size; pos++)
+			{
+				auto& moves = ans[pos];
+				auto const row = pos / side_size;
+				auto const col = pos % side_size;
+				if (col > 0) moves.targets[moves.count++] = pos - 1U;
+				if (col + 1 < side_size) moves.targets[moves.count++] = pos + 1U;
+				if (row > 0) moves.targets[moves.count++] = pos - side_size;
+				if (row + 1 < side_size) moves.targets[moves.count++] = pos + side_size;
+			}
+			return ans;
+		}();
+	//[tile][pos], tile t belongs at position t
+	constexpr static manhattan_table_t manhattan_table = []()
+		{
+			manhattan_table_t ans{};
+			for (std::uint8_t tile = 0; tile < board_size; tile++)
+			{
+				for (std::uint8_t pos = 0; pos < board_size; pos++)
+				{
+					int const rows = tile / side_size - pos / side_size;
+					int const cols = tile % side_size - pos % side_size;
+					ans[tile][pos] = static_cast<std::uint8_t>((rows < 0 ? -rows : rows) + (cols < 0 ? -cols : cols));
+				}
+			}
+			return ans;
+		}();
+	//[tile][blank pos][move]: heuristic change when the blank takes move_table[blank pos].targets[move]
+	//and tile slides from there into the old blank position
+	constexpr static delta_table_t delta_table = []()
+		{
+			delta_table_t ans{};
+			for (std::uint8_t tile = 1; tile < board_size; tile++)
+			{
+				for (std::uint8_t pos = 0; pos < board_size; pos++)
+				{
+					auto const& moves = move_table[pos];
+					for (std::uint8_t move = 0; move < moves.count; move++)
+					{
+						ans[tile][pos][move] = static_cast<std::int8_t>(manhattan_table[tile][pos] - manhattan_table[tile][moves.targets[move]]);
+					}
+				}
+			}
+			return ans;
+		}();
+
 	template<std::ranges::bidirectional_range Rng>
-	constexpr board_t(bool, Rng&& r) noexcept
-		: m_empty_cell_index{}, m_cells{}
+	explicit constexpr board_t(Rng&& r) noexcept
+		: m_cells{}, m_empty_cell_index{}
 	{
-		assert(r.size() == board_size);
-		std::unordered_set<cell_t> unique_set;
-		std::uint8_t i = board_size;
-		for (auto cell : std::ranges::reverse_view(r))
+		assert(std::ranges::size(r) == board_size);
+		[[maybe_unused]] std::uint32_t unique_set = 0;
+		std::uint8_t pos = 0;
+		for (auto const cell : r)
 		{
-			assert(unique_set.insert(cell).second);
-			m_cells <<= cell_width;
-			m_cells |= cells_t{ cell.to_ulong() };
+			assert(!(unique_set & (1U << cell)));
+			unique_set |= 1U << cell;
+			word(m_cells, pos) |= static_cast<std::uint64_t>(cell) << shift(pos);
 			if (cell_t{} == cell)
 			{
-				m_empty_cell_index = i;
+				m_empty_cell_index = pos + 1U;
 			}
-			i--;
+			pos++;
 		}
 	}
 	constexpr board_t(std::initializer_list<cell_t> cells) noexcept
-		: board_t(true, cells)
+		: board_t(std::ranges::subrange(cells))
 	{
 	}
 	constexpr board_t(std::array<cell_t, board_size> const& cells) noexcept
-		: board_t(true, cells)
+		: board_t(std::ranges::subrange(cells))
 	{
 	}
-	constexpr board_t swap_with_empty(std::uint8_t j) const noexcept
+	//inverse of reading m_cells, e.g. for boards stored on disk
+	constexpr static board_t unpack(cells_t const& cells) noexcept
 	{
-		auto ans = *this;
-		ans.m_empty_cell_index = j;
-		auto i = m_empty_cell_index;
+		std::array<cell_t, board_size> tiles;
+		for (std::uint8_t pos = 0; pos < board_size; pos++)
+		{
+			tiles[pos] = static_cast<cell_t>((word(cells, pos) >> shift(pos)) & cell_mask);
+		}
+		return board_t{ tiles };
+	}
+	//0 based blank positions before and after a move
+	constexpr static move_t direction(std::uint8_t const from, std::uint8_t const to) noexcept
+	{
+		if (to + 1U == from) return move_t::left;
+		if (from + 1U == to) return move_t::right;
+		return to < from ? move_t::up : move_t::down;
+	}
+	constexpr static std::int8_t offset(move_t const move) noexcept
+	{
+		constexpr std::array<std::int8_t, 4> offsets{ -1, 1, -static_cast<std::int8_t>(side_size), side_size };
+		return offsets[static_cast<std::uint8_t>(move)];
+	}
+	constexpr board_t apply(move_t const move) const noexcept
+	{
+		return move_empty(m_empty_cell_index, m_empty_cell_index + offset(move));
+	}
+	constexpr board_t move_empty(std::uint8_t i, std::uint8_t j) const noexcept
+	{
+		assert(i == m_empty_cell_index);
 		--i;
 		--j;
 		assert(i < board_size);
 		assert(j < board_size);
-		for (std::uint8_t k = 0; k < cell_width; k++)
-		{
-			ans.m_cells.set(i * cell_width + k, m_cells[j * cell_width + k]);
-			ans.m_cells.set(j * cell_width + k, m_cells[i * cell_width + k]);
-		}
-		assert(this->parity() == ans.parity());
+		auto ans = *this;
+		std::uint64_t const moved = tile(j);
+		word(ans.m_cells, j) -= moved << shift(j);
+		word(ans.m_cells, i) += moved << shift(i);
+		ans.m_empty_cell_index = j + 1U;
 		return ans;
 	}
 	constexpr bool operator == (board_t const& other) const noexcept
 	{
 		return m_cells == other.m_cells;
 	}
-	constexpr std::uint8_t heuristic() const noexcept
+	constexpr std::uint8_t tile(std::uint8_t pos) const noexcept
+	{
+		return static_cast<std::uint8_t>((word(m_cells, pos) >> shift(pos)) & cell_mask);
+	}
+	constexpr std::uint8_t empty_cell_index() const noexcept
+	{
+		return m_empty_cell_index;
+	}
+	constexpr static std::uint8_t manhattan(std::uint8_t const tile, std::uint8_t const pos) noexcept
+	{
+		return manhattan_table[tile][pos];
+	}
+	constexpr std::uint16_t heuristic() const noexcept
 	{
-		std::uint8_t ans = 0;
-		for (std::uint8_t current_pos = 0ui8; current_pos < board_size; current_pos++)
+		std::uint16_t ans = 0;
+		for (std::uint8_t pos = 0U; pos < board_size; pos++)
 		{
-			if (current_pos == (m_empty_cell_index - 1ui8)) continue;
-			auto const shift = cell_width * current_pos;
-			std::uint8_t const right_pos = ((m_cells >> shift).to_ullong() - 1U) & 0x0f;
-			if (current_pos != right_pos)
-			{
-				auto const current_dv = std::div(current_pos, side_size);
-				auto const right_dv = std::div(right_pos, side_size);
-				ans += std::abs(current_dv.quot - right_dv.quot);
-				ans += std::abs(current_dv.rem - right_dv.rem);
-			}
+			ans += manhattan_table[tile(pos)][pos];
+		}
+		return ans - manhattan_table[0][m_empty_cell_index - 1U];
+	}
+	//pairs of tiles, the blank left out, standing in the wrong order: one pass in which
+	//every tile counts the larger tiles already seen, kept as a bit set
+	constexpr std::uint32_t inversions() const noexcept
+	{
+		static_assert(board_size <= 64U);
+		std::uint32_t ans = 0;
+		std::uint64_t seen = 0;
+		for (std::uint8_t pos = 0; pos < board_size; pos++)
+		{
+			auto const t = tile(pos);
+			if (cell_t{} == t) continue;
+			ans += static_cast<std::uint32_t>(std::popcount(seen >> t));
+			seen |= std::uint64_t{ 1 } << t;
 		}
 		return ans;
 	}
-	constexpr bool parity() noexcept
+	constexpr bool parity() const noexcept
 	{
-		int ans = 0;
-		for (std::uint8_t i = 0; i < board_size; i++)
+		return 1U == (inversions() & 1U);
+	}
+	//against the goal {0, 1, ..., board_size - 1}: on even widths every vertical move
+	//changes the inversion parity together with the blank row
+	constexpr bool solvable() const noexcept
+	{
+		if constexpr (1 == side_size % 2)
 		{
-			if (i == (m_empty_cell_index-1ui8)) continue;
-			auto const shift = cell_width * (i * side_size);
-			auto const lhs = ((m_cells >> shift).to_ullong() & 0x0f);
-			for (std::uint8_t j = i + 1ui8; j < board_size; j++)
-			{
-				if (j == (m_empty_cell_index-1ui8)) continue;
-				auto const shift = cell_width * (j * side_size);
-				auto const rhs = ((m_cells >> shift).to_ullong() & 0x0f);
-				if (lhs > rhs)
-				{
-					ans++;
-				}
-			}
+			return !parity();
+		}
+		else
+		{
+			return parity() == (1 == ((m_empty_cell_index - 1) / side_size) % 2);
 		}
-		return ans & 1;
+	}
+	//whether any sequence of moves turns this board into goal
+	constexpr bool reaches(board_t<side_size> const& goal) const noexcept
+	{
+		return solvable() == goal.solvable();
 	}
 	friend std::ostream& operator<<(std::ostream& os, board_t<side_size> arg)
 	{
@@ -117,42 +243,45 @@ struct board_t
 		{
 			for (std::uint8_t col = 0; col < side_size; col++)
 			{
-				auto const shift = cell_width * (row * side_size + col);
-				os << ((arg.m_cells >> shift).to_ullong() & 0x0f) << ' ';
+				os << std::setw(2) << static_cast<int>(arg.tile(row * side_size + col)) << ' ';
 			}
 			os << '\n';
 		}
 		return os;
 	}
-	std::experimental::generator<board_t<side_size>> neighbors() const
+	//children in move_table order, in place; for_each_neighbor hands them to a callback instead
+	constexpr successors_t neighbors() const noexcept
 	{
-		if (!is_left_border()) co_yield swap_with_empty(m_empty_cell_index - 1U);
-		if (!is_right_border()) co_yield swap_with_empty(m_empty_cell_index + 1U);
-		if (!is_top_border()) co_yield swap_with_empty(m_empty_cell_index - side_size);
-		if (!is_bottom_border()) co_yield swap_with_empty(m_empty_cell_index + side_size);
+		successors_t ans;
+		for_each_neighbor([&ans](board_t const& child) { ans.push_back(child); });
+		return ans;
 	}
-private:
-	//1   2  3  4
-	//5   6  7  8
-	//9  10 11 12
-	//13 14 15 16
-	constexpr bool is_right_border() const noexcept
+	template <typename visitor_t>
+	constexpr void for_each_neighbor(visitor_t&& visit) const
 	{
-		return 0 == m_empty_cell_index % side_size;
+		auto const empty_idx = m_empty_cell_index;
+		auto const& moves = move_table[empty_idx - 1U];
+		for (auto const target : std::span{ moves.targets }.first(moves.count))
+		{
+			visit(move_empty(empty_idx, target + 1U));
+		}
 	}
-	constexpr bool is_left_border() const noexcept
+private:
+	friend void test();
+	constexpr static std::uint8_t shift(std::uint8_t const pos) noexcept
 	{
-		return 1U == m_empty_cell_index % side_size;
+		return pos % cells_per_word * cell_width;
 	}
-	constexpr bool is_top_border() const noexcept
+	constexpr static std::uint64_t& word(cells_t& cells, std::uint8_t const pos) noexcept
 	{
-		return m_empty_cell_index <= side_size;
+		if constexpr (1 == word_count) return cells;
+		else return cells[pos / cells_per_word];
 	}
-	constexpr bool is_bottom_border() const noexcept
+	constexpr static std::uint64_t word(cells_t const& cells, std::uint8_t const pos) noexcept
 	{
-		return (m_empty_cell_index + side_size) > (side_size * side_size);
+		if constexpr (1 == word_count) return cells;
+		else return cells[pos / cells_per_word];
 	}
-	friend void test();
 };
 
 template<std::uint8_t side_size>
@@ -160,6 +289,23 @@ struct std::hash<board_t<side_size>>
 {
 	constexpr std::size_t operator()(const board_t<side_size>& arg) const noexcept
 	{
-		return std::hash<typename board_t<side_size>::cells_t>{}(arg.m_cells);
+		std::uint64_t h = 0;
+		if constexpr (1 == board_t<side_size>::word_count)
+		{
+			h = arg.m_cells;
+		}
+		else
+		{
+			for (auto const word : arg.m_cells)
+			{
+				h = (h ^ word) * 0x9e3779b97f4a7c15ULL;
+			}
+		}
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdULL;
+		h ^= h >> 33;
+		h *= 0xc4ceb9fe1a85ec53ULL;
+		h ^= h >> 33;
+		return static_cast<std::size_t>(h);
 	}
-};
\ No newline at end of file
+};
@@ -0,0 +1,252 @@
+#pragma once
+
+#include "../Common/counters.hpp"
+#include "npuzzle.hpp"
+#include "npuzzle_closed_list.hpp"
+#include "npuzzle_heuristic.hpp"
+#include "npuzzle_solver.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <queue>
+#include <tuple>
+#include <vector>
+
+struct anytime_options_t
+{
+	//f = g + weight * h; every improved solution lowers the weight by weight_step down to 1
+	double initial_weight = 3.0;
+	double weight_step = 0.5;
+	std::chrono::milliseconds time_budget{ 1000 };
+};
+
+//one solution as it was found: its cost, the weight that found it and the proven
+//ratio of that cost to the optimum
+struct anytime_improvement_t
+{
+	std::uint16_t cost;
+	double weight;
+	double bound;
+	std::chrono::duration<double, std::milli> elapsed;
+	void write_json(std::ostream& os) const
+	{
+		os << "{\"cost\":" << cost << ",\"weight\":" << weight << ",\"bound\":" << bound
+			<< ",\"elapsed_ms\":" << elapsed.count() << '}';
+	}
+};
+
+//ARA*: weighted A* that reuses its search effort as the weight goes down. Nodes
+//improved after their expansion in the current round wait in an inconsistent list
+//instead of being reopened; they rejoin the open list when the next round starts
+//with a lower weight. Nodes whose g + h reaches the incumbent are never kept. The
+//search stops when the time budget runs out or the incumbent is proven optimal,
+//and returns the best solution found so far.
+template <std::uint8_t side_size, typename heuristic_t = manhattan_t>
+class ara_t
+{
+public:
+	explicit ara_t(heuristic_t const& heuristic = {}, anytime_options_t const& options = {}, std::size_t const expected = expected_nodes<side_size>())
+		: m_heuristic{ heuristic }, m_options{ options }
+	{
+		m_nodes.reserve(expected);
+	}
+	//closed list nodes that fit into bytes, for expected_nodes()
+	static std::size_t node_budget(std::size_t const bytes) noexcept
+	{
+		return bytes / history_t::bytes_per_node();
+	}
+	search_result_t operator()(board_t<side_size> const start, board_t<side_size> const goal)
+	{
+		using clock_t = std::chrono::steady_clock;
+		search_result_t ans;
+		{
+			scoped_phase_t const phase{ ans.counters.phases, "search" };
+			auto const begin = clock_t::now();
+			auto const deadline = begin + m_options.time_budget;
+			m_nodes.clear();
+			m_open = {};
+			m_inconsistent.clear();
+			m_improvements.clear();
+			m_round = 1U;
+			m_incumbent = start == goal ? 0U : infinity;
+			auto weight = std::max(1.0, m_options.initial_weight);
+			node_t root{};
+			root.h = m_heuristic(start);
+			root.open = true;
+			push(m_nodes.try_emplace(start, root).first, weight);
+			ans.counters.generations = 1U;
+			for (bool timed_out = false;; weight = std::max(1.0, weight - m_options.weight_step), next_round(weight))
+			{
+				auto const incumbent = m_incumbent;
+				while (!m_open.empty())
+				{
+					auto const [key, g, parent] = m_open.top();
+					if (!m_nodes.value(parent).open || g != m_nodes.value(parent).depth)
+					{
+						m_open.pop();
+						continue;
+					}
+					if (m_incumbent <= key) break;
+					if (0U == (ans.counters.expansions & 1023U) && clock_t::now() >= deadline)
+					{
+						timed_out = true;
+						break;
+					}
+					m_open.pop();
+					expand(parent, goal, weight, ans);
+					ans.counters.open_size(m_open.size());
+				}
+				if (m_incumbent < incumbent || (0U == m_incumbent && !ans.solved))
+				{
+					//a parent improved after its child was stored only shortens the path
+					ans.moves = trace_moves(m_nodes, goal);
+					m_incumbent = static_cast<std::uint16_t>(ans.moves.size());
+					ans.solved = true;
+					ans.depth = ans.cost = m_incumbent;
+					m_improvements.push_back({ m_incumbent, weight, bound(weight), clock_t::now() - begin });
+				}
+				//a round at weight 1 that ran to completion proves the incumbent optimal
+				if (timed_out || 1.0 == weight || clock_t::now() >= deadline) break;
+			}
+			ans.counters.load_factor = m_nodes.load_factor();
+		}
+		return ans;
+	}
+	//every solution of the last search, in the order found
+	std::vector<anytime_improvement_t> const& improvements() const noexcept
+	{
+		return m_improvements;
+	}
+private:
+	constexpr static std::uint16_t infinity = std::numeric_limits<std::uint16_t>::max();
+	struct node_t : trail_t
+	{
+		std::uint16_t h = 0U;
+		//round in which the node was last expanded; expanded in the current round means closed
+		std::uint16_t closed_round = 0U;
+		bool open = false;
+		bool inconsistent = false;
+	};
+	using history_t = closed_list_t<board_t<side_size>, node_t>;
+	using index_t = typename history_t::index_t;
+	//lowest g + weight * h first, deepest g among equal keys; entries of nodes improved
+	//since they were pushed are skipped on pop
+	using entry_t = std::tuple<double, std::uint16_t, index_t>;
+	struct cmp_t
+	{
+		bool operator()(entry_t const& lhs, entry_t const& rhs) const noexcept
+		{
+			if (std::get<0>(lhs) != std::get<0>(rhs)) return std::get<0>(lhs) > std::get<0>(rhs);
+			return std::get<1>(lhs) < std::get<1>(rhs);
+		}
+	};
+
+	void push(index_t const index, double const weight)
+	{
+		auto const& node = m_nodes.value(index);
+		m_open.emplace(node.depth + weight * node.h, node.depth, index);
+	}
+	void expand(index_t const parent, board_t<side_size> const goal, double const weight, search_result_t& ans)
+	{
+		auto const board = m_nodes.key(parent);
+		auto& parent_node = m_nodes.value(parent);
+		parent_node.open = false;
+		parent_node.closed_round = m_round;
+		std::uint16_t const depth = parent_node.depth + 1U;
+		ans.counters.expand(parent_node.depth);
+		auto const empty_idx = board.empty_cell_index();
+		for (auto const& neighbor : board.neighbors())
+		{
+			ans.counters.generations++;
+			node_t child{};
+			static_cast<trail_t&>(child) = trail_t{ depth, board_t<side_size>::direction(empty_idx - 1U, neighbor.empty_cell_index() - 1U) };
+			auto index = m_nodes.find(neighbor);
+			child.h = history_t::none == index ? m_heuristic(neighbor) : m_nodes.value(index).h;
+			if (depth + child.h >= m_incumbent)
+			{
+				if (history_t::none != index) ans.counters.duplicates++;
+				continue;
+			}
+			if (history_t::none == index)
+			{
+				index = m_nodes.try_emplace(neighbor, child).first;
+			}
+			else
+			{
+				auto& node = m_nodes.value(index);
+				if (node.depth <= depth)
+				{
+					ans.counters.duplicates++;
+					continue;
+				}
+				child.closed_round = node.closed_round;
+				child.open = node.open;
+				child.inconsistent = node.inconsistent;
+				node = child;
+			}
+			ans.max_depth = std::max(ans.max_depth, depth);
+			auto& node = m_nodes.value(index);
+			if (neighbor == goal)
+			{
+				m_incumbent = depth;
+			}
+			else if (m_round == node.closed_round)
+			{
+				if (!node.inconsistent) m_inconsistent.push_back(index);
+				node.inconsistent = true;
+			}
+			else
+			{
+				node.open = true;
+				push(index, weight);
+			}
+		}
+	}
+	//incumbent over the lowest g + h still waiting, which no solution can undercut
+	double bound(double const weight) const noexcept
+	{
+		std::uint16_t lower = m_incumbent;
+		for (index_t i = 0; i < m_nodes.size(); i++)
+		{
+			auto const& node = m_nodes.value(i);
+			if (node.open || node.inconsistent) lower = std::min<std::uint16_t>(lower, node.depth + node.h);
+		}
+		return 0U == lower ? 1.0 : std::min(weight, static_cast<double>(m_incumbent) / lower);
+	}
+	//the inconsistent nodes join the open list, which is ordered again under the new weight
+	void next_round(double const weight)
+	{
+		for (auto const index : m_inconsistent)
+		{
+			m_nodes.value(index).open = true;
+			m_nodes.value(index).inconsistent = false;
+		}
+		m_inconsistent.clear();
+		m_open = {};
+		for (index_t i = 0; i < m_nodes.size(); i++)
+		{
+			if (m_nodes.value(i).open && m_nodes.value(i).depth + m_nodes.value(i).h < m_incumbent) push(i, weight);
+			else m_nodes.value(i).open = false;
+		}
+		m_round++;
+	}
+
+	heuristic_t m_heuristic;
+	anytime_options_t m_options;
+	history_t m_nodes;
+	std::priority_queue<entry_t, std::vector<entry_t>, cmp_t> m_open;
+	std::vector<index_t> m_inconsistent;
+	std::vector<anytime_improvement_t> m_improvements;
+	std::uint16_t m_round = 1U;
+	std::uint16_t m_incumbent = infinity;
+};
+
+template <std::uint8_t side_size, typename heuristic_t = manhattan_t>
+search_result_t ara(board_t<side_size> const start, board_t<side_size> const goal, heuristic_t const& heuristic = {}, anytime_options_t const& options = {})
+{
+	return ara_t<side_size, heuristic_t const&>{ heuristic, options }(start, goal);
+}
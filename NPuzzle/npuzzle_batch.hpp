@@ -0,0 +1,250 @@
+#pragma once
+
+#include "npuzzle.hpp"
+#include "npuzzle_anytime.hpp"
+#include "npuzzle_bounded.hpp"
+#include "npuzzle_heuristic.hpp"
+#include "npuzzle_solver.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <istream>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <ranges>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+//Instance format: one board per line, tiles separated by blanks, row by row,
+//0 for the blank; 9 tiles for 3x3, 16 for 4x4, 25 for 5x5. Empty lines and lines starting
+//with '#' are skipped. Every instance yields one JSON line, in completion order.
+struct batch_options_t
+{
+	std::string algorithm = "idastar";
+	unsigned thread_count = std::max(1U, std::thread::hardware_concurrency());
+	std::vector<std::string> pdb_paths;
+	//smastar keeps at most max_nodes nodes, or as many as fit into memory_budget bytes when that is set;
+	//astar and ara reserve closed list room for as many nodes as fit into memory_budget up front
+	std::size_t max_nodes = std::size_t{ 1 } << 22;
+	std::size_t memory_budget = 0U;
+	anytime_options_t anytime;
+};
+
+//The one engine --algorithm names, built once per worker, board size and heuristic.
+template <std::uint8_t side_size, typename heuristic_t>
+class batch_engine_t
+{
+public:
+	batch_engine_t(heuristic_t const& heuristic, batch_options_t const& options)
+		: m_engine{ make(heuristic, options) }
+	{
+	}
+	search_result_t operator()(board_t<side_size> const start, board_t<side_size> const goal)
+	{
+		return std::visit([start, goal](auto& engine) { return engine(start, goal); }, m_engine);
+	}
+	//the improvements of ara's last search, nullptr for the other engines
+	std::vector<anytime_improvement_t> const* improvements() const noexcept
+	{
+		auto const* const ara = std::get_if<ara_t<side_size, heuristic_t>>(&m_engine);
+		return ara ? &ara->improvements() : nullptr;
+	}
+private:
+	using engine_t = std::variant<astar_t<side_size, heuristic_t>, idastar_t<side_size, heuristic_t>,
+		smastar_t<side_size, heuristic_t>, ara_t<side_size, heuristic_t>>;
+	static engine_t make(heuristic_t const& heuristic, batch_options_t const& options)
+	{
+		if ("astar" == options.algorithm)
+		{
+			return engine_t{ std::in_place_index<0>, heuristic,
+				expected_nodes<side_size>(astar_t<side_size, heuristic_t>::node_budget(options.memory_budget)) };
+		}
+		if ("smastar" == options.algorithm)
+		{
+			return engine_t{ std::in_place_index<2>, heuristic, 0U != options.memory_budget
+				? smastar_t<side_size, heuristic_t>::node_budget(options.memory_budget) : options.max_nodes };
+		}
+		if ("ara" == options.algorithm)
+		{
+			return engine_t{ std::in_place_index<3>, heuristic, options.anytime,
+				expected_nodes<side_size>(ara_t<side_size, heuristic_t>::node_budget(options.memory_budget)) };
+		}
+		return engine_t{ std::in_place_index<1>, heuristic };
+	}
+	engine_t m_engine;
+};
+
+template <std::uint8_t side_size>
+class batch_worker_t
+{
+public:
+	batch_worker_t(pattern_database_t<side_size> const* pdb, batch_options_t const& options)
+		: m_pdb{ pdb }, m_options{ options }
+	{
+	}
+	void operator()(std::ostream& os, std::vector<int> const& tiles)
+	{
+		std::array<std::uint8_t, board_t<side_size>::board_size> cells;
+		std::ranges::copy(tiles, cells.begin());
+		board_t<side_size> const start{ cells };
+		if (!start.solvable())
+		{
+			os << ",\"solved\":false,\"error\":\"unsolvable\"";
+			return;
+		}
+		std::ranges::sort(cells);
+		board_t<side_size> const goal{ cells };
+		if (m_pdb)
+		{
+			if (!m_pdb_engine) m_pdb_engine.emplace(*m_pdb, m_options);
+			solve(os, *m_pdb_engine, start, goal);
+		}
+		else
+		{
+			if (!m_manhattan_engine) m_manhattan_engine.emplace(manhattan_t{}, m_options);
+			solve(os, *m_manhattan_engine, start, goal);
+		}
+	}
+private:
+	template <typename engine_t>
+	static void solve(std::ostream& os, engine_t& engine, board_t<side_size> const start, board_t<side_size> const goal)
+	{
+		auto const begin = std::chrono::steady_clock::now();
+		auto const ans = engine(start, goal);
+		std::chrono::duration<double, std::milli> const wall_time = std::chrono::steady_clock::now() - begin;
+		os << ",\"solved\":" << (ans.solved ? "true" : "false");
+		os << ",\"length\":" << ans.depth;
+		os << ",\"moves\":\"";
+		for (auto const move : ans.moves)
+		{
+			os << move;
+		}
+		os << '"';
+		os << ",\"nodes_expanded\":" << ans.counters.expansions;
+		os << ",\"wall_time_ms\":" << wall_time.count();
+		if (auto const* const improvements = engine.improvements())
+		{
+			os << ",\"improvements\":[";
+			for (std::size_t i = 0; i < improvements->size(); i++)
+			{
+				os << (0U == i ? "" : ",");
+				(*improvements)[i].write_json(os);
+			}
+			os << ']';
+		}
+		os << ",\"counters\":";
+		ans.counters.write_json(os);
+	}
+	pattern_database_t<side_size> const* m_pdb;
+	batch_options_t const& m_options;
+	std::optional<batch_engine_t<side_size, manhattan_t>> m_manhattan_engine;
+	std::optional<batch_engine_t<side_size, pattern_database_t<side_size> const&>> m_pdb_engine;
+};
+
+inline int run_batch(std::istream& is, std::ostream& os, batch_options_t const& options)
+{
+	std::optional<pattern_database_t<3>> pdb3;
+	std::optional<pattern_database_t<4>> pdb4;
+	for (auto const& path : options.pdb_paths)
+	{
+		switch (pattern_database_side_size(path))
+		{
+		case 3: pdb3.emplace(path); break;
+		case 4: pdb4.emplace(path); break;
+		default: throw std::runtime_error("unsupported pattern database " + path);
+		}
+	}
+	std::mutex input_mutex, output_mutex;
+	std::uint64_t next_instance = 0;
+	//records go out through the stream's buffer, and to the reader about once a second
+	constexpr std::chrono::seconds flush_interval{ 1 };
+	auto last_flush = std::chrono::steady_clock::now();
+	auto worker = [&]()
+		{
+			batch_worker_t<3> solve3{ pdb3 ? &*pdb3 : nullptr, options };
+			batch_worker_t<4> solve4{ pdb4 ? &*pdb4 : nullptr, options };
+			batch_worker_t<5> solve5{ nullptr, options };
+			std::string line;
+			std::vector<int> tiles;
+			for (;;)
+			{
+				std::uint64_t instance;
+				{
+					std::lock_guard g{ input_mutex };
+					do
+					{
+						if (!std::getline(is, line)) return;
+					} while (line.empty() || '#' == line.front());
+					instance = next_instance++;
+				}
+				tiles.clear();
+				std::istringstream tokens{ line };
+				for (int tile; tokens >> tile;)
+				{
+					tiles.push_back(tile);
+				}
+				auto sorted = tiles;
+				std::ranges::sort(sorted);
+				bool const valid = tokens.eof() && !sorted.empty()
+					&& std::ranges::equal(sorted, std::views::iota(0, static_cast<int>(sorted.size())));
+				std::ostringstream record;
+				//a search that runs out of memory or node indices fails its own instance only
+				try
+				{
+					if (valid && 9 == tiles.size())
+					{
+						solve3(record, tiles);
+					}
+					else if (valid && 16 == tiles.size())
+					{
+						solve4(record, tiles);
+					}
+					else if (valid && 25 == tiles.size())
+					{
+						solve5(record, tiles);
+					}
+					else
+					{
+						record << ",\"solved\":false,\"error\":\"invalid instance\"";
+					}
+				}
+				catch (std::exception const& e)
+				{
+					record.str({});
+					record << ",\"solved\":false,\"error\":\"";
+					for (char const* c = e.what(); '\0' != *c; c++)
+					{
+						if ('"' == *c || '\\' == *c) record << '\\';
+						record << *c;
+					}
+					record << '"';
+				}
+				std::lock_guard g{ output_mutex };
+				os << "{\"instance\":" << instance << ",\"algorithm\":\"" << options.algorithm << '"' << record.str() << "}\n";
+				if (auto const now = std::chrono::steady_clock::now(); now - last_flush >= flush_interval)
+				{
+					os.flush();
+					last_flush = now;
+				}
+			}
+		};
+	{
+		std::vector<std::jthread> tasks;
+		tasks.reserve(options.thread_count);
+		for (unsigned i = 0; i < options.thread_count; i++)
+		{
+			tasks.emplace_back(worker);
+		}
+	}
+	os.flush();
+	return os ? 0 : 1;
+}
@@ -0,0 +1,311 @@
+#pragma once
+
+#include "npuzzle.hpp"
+#include "npuzzle_closed_list.hpp"
+#include "npuzzle_heuristic.hpp"
+#include "npuzzle_open_list.hpp"
+#include "npuzzle_solver.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+//Moves from start to the meeting board, then the backward search's moves undone in reverse order.
+template <typename history_t, typename board>
+std::vector<move_t> join_moves(history_t const& forward_nodes, history_t const& backward_nodes, board meeting)
+{
+	auto ans = trace_moves(forward_nodes, meeting);
+	for (trail_t trail = backward_nodes.value(backward_nodes.find(meeting)); 0U != trail.depth; trail = backward_nodes.value(backward_nodes.find(meeting)))
+	{
+		ans.push_back(opposite(trail.move()));
+		meeting = meeting.apply(opposite(trail.move()));
+	}
+	return ans;
+}
+
+//Grows whole layers from start and goal, always extending the smaller frontier.
+//Both tables only ever hold complete layers plus the one being built, so the
+//first child found in the opposite table closes an optimal path.
+template <std::uint8_t side_size>
+class bibfs_t
+{
+public:
+	bibfs_t()
+	{
+		for (auto& dir : m_directions)
+		{
+			dir.nodes.reserve(expected_nodes<side_size>() / 2U);
+		}
+	}
+	search_result_t operator()(board_t<side_size> const start, board_t<side_size> const goal)
+	{
+		search_result_t ans;
+		std::optional<board_t<side_size>> meeting;
+		{
+			scoped_phase_t const phase{ ans.counters.phases, "search" };
+			std::array<board_t<side_size>, 2> const roots{ start, goal };
+			for (std::size_t side = 0; side < 2; side++)
+			{
+				auto& dir = m_directions[side];
+				dir.nodes.clear();
+				dir.frontier.clear();
+				dir.depth = 0U;
+				dir.nodes.try_emplace(roots[side], trail_t{});
+				dir.frontier.push_back(roots[side]);
+			}
+			ans.counters.generations = 2U;
+			if (start == goal) meeting = start;
+			while (!meeting && !m_directions[0].frontier.empty() && !m_directions[1].frontier.empty())
+			{
+				auto const side = m_directions[0].frontier.size() <= m_directions[1].frontier.size() ? 0U : 1U;
+				auto& dir = m_directions[side];
+				auto const& other = m_directions[1U - side];
+				std::uint16_t const depth = ++dir.depth;
+				m_next.clear();
+				for (auto const& parent : dir.frontier)
+				{
+					ans.counters.expand(depth - 1U);
+					auto const empty_idx = parent.empty_cell_index();
+					for (auto const& neighbor : parent.neighbors())
+					{
+						trail_t const trail{ depth, board_t<side_size>::direction(empty_idx - 1U, neighbor.empty_cell_index() - 1U) };
+						ans.counters.generations++;
+						if (!dir.nodes.try_emplace(neighbor, trail).second)
+						{
+							ans.counters.duplicates++;
+							continue;
+						}
+						m_next.push_back(neighbor);
+						if (other.nodes.contains(neighbor))
+						{
+							meeting = neighbor;
+							break;
+						}
+					}
+					if (meeting) break;
+				}
+				dir.frontier.swap(m_next);
+				ans.counters.open_size(m_directions[0].frontier.size() + m_directions[1].frontier.size());
+			}
+			ans.counters.load_factor = std::max(m_directions[0].nodes.load_factor(), m_directions[1].nodes.load_factor());
+		}
+		ans.max_depth = std::max(m_directions[0].depth, m_directions[1].depth);
+		if (meeting)
+		{
+			scoped_phase_t const phase{ ans.counters.phases, "trace" };
+			ans.solved = true;
+			ans.moves = join_moves(m_directions[0].nodes, m_directions[1].nodes, *meeting);
+			ans.depth = ans.cost = static_cast<std::uint16_t>(ans.moves.size());
+		}
+		return ans;
+	}
+private:
+	struct direction_t
+	{
+		closed_list_t<board_t<side_size>, trail_t> nodes;
+		std::vector<board_t<side_size>> frontier;
+		std::uint16_t depth = 0U;
+	};
+	std::array<direction_t, 2> m_directions;
+	std::vector<board_t<side_size>> m_next;
+};
+
+template <std::uint8_t side_size>
+search_result_t bibfs(board_t<side_size> const start, board_t<side_size> const goal)
+{
+	return bibfs_t<side_size>{}(start, goal);
+}
+
+//MM: both directions pop by pr = max(g + h, 2g), so neither search crosses the
+//middle before the other one gets there. U, the best joined cost seen so far, is
+//optimal once U <= max(C, fmin_f, fmin_b, gmin_f + gmin_b + 1), C being the lower pr.
+//Each direction estimates with the Manhattan distance to its own target; pattern
+//databases only answer distances to the canonical goal, so they cannot run backwards.
+template <std::uint8_t side_size, template <typename> typename open_list_t = bucket_open_list_t>
+class mm_t
+{
+public:
+	mm_t()
+	{
+		for (auto& dir : m_directions)
+		{
+			dir.nodes.reserve(expected_nodes<side_size>() / 2U);
+		}
+	}
+	search_result_t operator()(board_t<side_size> const start, board_t<side_size> const goal)
+	{
+		search_result_t ans;
+		std::uint16_t best = start == goal ? 0U : none;
+		std::optional<board_t<side_size>> meeting;
+		{
+			scoped_phase_t const phase{ ans.counters.phases, "search" };
+			std::array<board_t<side_size>, 2> const roots{ start, goal };
+			std::array<manhattan_to_t<board_t<side_size>>, 2> const heuristics{ manhattan_to_t{ goal }, manhattan_to_t{ start } };
+			for (std::size_t side = 0; side < 2; side++)
+			{
+				auto& dir = m_directions[side];
+				dir.nodes.clear();
+				dir.open.clear();
+				dir.stats.clear();
+				node_t const root{ trail_t{}, heuristics[side](roots[side]), true };
+				dir.nodes.try_emplace(roots[side], root);
+				dir.open.push(root.pr(), 0U, roots[side]);
+				dir.stats.add(root);
+			}
+			ans.counters.generations = 2U;
+			if (start == goal) meeting = start;
+			while (!m_directions[0].stats.empty() && !m_directions[1].stats.empty())
+			{
+				auto const& forward = m_directions[0].stats;
+				auto const& backward = m_directions[1].stats;
+				auto const c = std::min(forward.min_pr(), backward.min_pr());
+				if (best <= std::max({ c, forward.min_f(), backward.min_f(), static_cast<std::uint16_t>(forward.min_g() + backward.min_g() + 1U) })) break;
+				auto const side = forward.min_pr() <= backward.min_pr() ? 0U : 1U;
+				auto& dir = m_directions[side];
+				auto const& other = m_directions[1U - side];
+				auto const parent = pop(dir);
+				std::uint16_t const g = dir.nodes.value(dir.nodes.find(parent)).depth + 1U;
+				ans.counters.expand(g - 1U);
+				ans.max_depth = std::max(ans.max_depth, g);
+				auto const empty_idx = parent.empty_cell_index();
+				for (auto const& neighbor : parent.neighbors())
+				{
+					trail_t const trail{ g, board_t<side_size>::direction(empty_idx - 1U, neighbor.empty_cell_index() - 1U) };
+					node_t const child{ trail, heuristics[side](neighbor), true };
+					auto const [index, inserted] = dir.nodes.try_emplace(neighbor, child);
+					ans.counters.generations++;
+					if (!inserted)
+					{
+						auto& node = dir.nodes.value(index);
+						if (node.depth <= g)
+						{
+							ans.counters.duplicates++;
+							continue;
+						}
+						if (node.open) dir.stats.remove(node);
+						node = child;
+					}
+					dir.open.push(child.pr(), g, neighbor);
+					dir.stats.add(child);
+					if (auto const match = other.nodes.find(neighbor); other.nodes.none != match && g + other.nodes.value(match).depth < best)
+					{
+						best = g + other.nodes.value(match).depth;
+						meeting = neighbor;
+					}
+				}
+				ans.counters.open_size(m_directions[0].open.size() + m_directions[1].open.size());
+			}
+			ans.counters.load_factor = std::max(m_directions[0].nodes.load_factor(), m_directions[1].nodes.load_factor());
+		}
+		if (meeting)
+		{
+			scoped_phase_t const phase{ ans.counters.phases, "trace" };
+			ans.solved = true;
+			ans.moves = join_moves(m_directions[0].nodes, m_directions[1].nodes, *meeting);
+			ans.depth = ans.cost = static_cast<std::uint16_t>(ans.moves.size());
+		}
+		return ans;
+	}
+private:
+	constexpr static std::uint16_t none = std::numeric_limits<std::uint16_t>::max();
+	struct node_t : trail_t
+	{
+		std::uint16_t h;
+		bool open;
+		constexpr std::uint16_t f() const noexcept
+		{
+			return depth + h;
+		}
+		constexpr std::uint16_t pr() const noexcept
+		{
+			return std::max<std::uint16_t>(depth + h, 2U * depth);
+		}
+	};
+	//how many open nodes sit at every g, f and pr; the minima are found by scanning up
+	class open_stats_t
+	{
+	public:
+		void add(node_t const& node)
+		{
+			update(node, 1);
+		}
+		void remove(node_t const& node)
+		{
+			update(node, -1);
+		}
+		bool empty() const noexcept
+		{
+			return 0U == m_size;
+		}
+		std::uint16_t min_g() const noexcept
+		{
+			return lowest(m_g);
+		}
+		std::uint16_t min_f() const noexcept
+		{
+			return lowest(m_f);
+		}
+		std::uint16_t min_pr() const noexcept
+		{
+			return lowest(m_pr);
+		}
+		void clear() noexcept
+		{
+			m_g.clear();
+			m_f.clear();
+			m_pr.clear();
+			m_size = 0U;
+		}
+	private:
+		using counts_t = std::vector<std::size_t>;
+		static void bump(counts_t& counts, std::uint16_t const key, int const delta)
+		{
+			if (key >= counts.size()) counts.resize(key + 1U);
+			counts[key] += delta;
+		}
+		static std::uint16_t lowest(counts_t const& counts) noexcept
+		{
+			auto const it = std::ranges::find_if(counts, [](auto const count) { return 0U != count; });
+			return counts.end() == it ? none : static_cast<std::uint16_t>(it - counts.begin());
+		}
+		void update(node_t const& node, int const delta)
+		{
+			bump(m_g, node.depth, delta);
+			bump(m_f, node.f(), delta);
+			bump(m_pr, node.pr(), delta);
+			m_size += delta;
+		}
+		counts_t m_g, m_f, m_pr;
+		std::size_t m_size = 0U;
+	};
+	struct direction_t
+	{
+		closed_list_t<board_t<side_size>, node_t> nodes;
+		open_list_t<board_t<side_size>> open;
+		open_stats_t stats;
+	};
+	//skips entries left behind by nodes reopened with a lower g
+	static board_t<side_size> pop(direction_t& dir)
+	{
+		for (;;)
+		{
+			auto const [pr, board] = dir.open.pop();
+			auto& node = dir.nodes.value(dir.nodes.find(board));
+			if (!node.open || node.pr() != pr) continue;
+			node.open = false;
+			dir.stats.remove(node);
+			return board;
+		}
+	}
+	std::array<direction_t, 2> m_directions;
+};
+
+template <std::uint8_t side_size, template <typename> typename open_list_t = bucket_open_list_t>
+search_result_t mm(board_t<side_size> const start, board_t<side_size> const goal)
+{
+	return mm_t<side_size, open_list_t>{}(start, goal);
+}
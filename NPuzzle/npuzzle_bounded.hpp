@@ -0,0 +1,248 @@
+#pragma once
+
+#include "npuzzle.hpp"
+#include "npuzzle_heuristic.hpp"
+#include "npuzzle_open_list.hpp"
+#include "npuzzle_solver.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <tuple>
+#include <vector>
+
+//SMA*: best first tree search that never holds more than max_nodes nodes. When
+//memory is full the shallowest leaf with the highest f is dropped and its parent
+//remembers the f it had; the parent is regenerated from there once it becomes the
+//best node again. Children inherit max(f(parent), g + h), so forgotten estimates
+//survive. The result is optimal whenever the optimal path fits into max_nodes;
+//nodes deeper than that get an infinite f.
+template <std::uint8_t side_size, typename heuristic_t = manhattan_t>
+class smastar_t
+{
+public:
+	explicit smastar_t(heuristic_t const& heuristic = {}, std::size_t const max_nodes = std::size_t{ 1 } << 22)
+		: m_heuristic{ heuristic }, m_max_nodes{ std::max<std::size_t>(max_nodes, 3U) }
+	{
+	}
+	//node budget that keeps the search under bytes: every node has an arena slot, a free
+	//list slot and a place in both heaps, all reserved up front
+	static std::size_t node_budget(std::size_t const bytes) noexcept
+	{
+		return bytes / (sizeof(node_t) + sizeof(std::uint32_t) + open_t::bytes_per_id() + leaves_t::bytes_per_id());
+	}
+	search_result_t operator()(board_t<side_size> const start, board_t<side_size> const goal)
+	{
+		search_result_t ans;
+		auto goal_id = none;
+		{
+			scoped_phase_t const phase{ ans.counters.phases, "search" };
+			m_nodes.clear();
+			m_free.clear();
+			m_open.clear();
+			m_leaves.clear();
+			//untouched pages cost no memory, and nothing reallocates past the budget
+			m_nodes.reserve(m_max_nodes);
+			m_free.reserve(m_max_nodes);
+			m_open.reserve(m_max_nodes);
+			m_leaves.reserve(m_max_nodes);
+			node_t root{ start };
+			root.f = m_heuristic(start);
+			insert(allocate(root));
+			ans.counters.generations = 1U;
+			while (!m_open.empty())
+			{
+				auto const best = m_open.top();
+				if (infinity == m_nodes[best].f) break;
+				if (m_nodes[best].board == goal)
+				{
+					goal_id = best;
+					break;
+				}
+				//every round adds a single successor
+				ans.counters.expand(m_nodes[best].g);
+				if (m_nodes.size() - m_free.size() == m_max_nodes && !prune(best)) break;
+				auto const slot = next_slot(best);
+				auto const& moves = board_t<side_size>::move_table[m_nodes[best].board.empty_cell_index() - 1U];
+				node_t child{ m_nodes[best].board.move_empty(m_nodes[best].board.empty_cell_index(), moves.targets[slot] + 1U) };
+				child.parent = best;
+				child.slot = slot;
+				child.g = m_nodes[best].g + 1U;
+				child.f = child.g + 1U >= m_max_nodes && !(child.board == goal)
+					? infinity : std::max<std::uint16_t>(m_nodes[best].f, child.g + m_heuristic(child.board));
+				auto const& child_moves = board_t<side_size>::move_table[child.board.empty_cell_index() - 1U];
+				for (std::uint8_t i = 0; i < child_moves.count; i++)
+				{
+					if (child_moves.targets[i] + 1U == m_nodes[best].board.empty_cell_index()) child.back = static_cast<std::uint8_t>(1U << i);
+				}
+				auto const id = allocate(child);
+				ans.counters.generations++;
+				ans.max_depth = std::max(ans.max_depth, child.g);
+				insert(id);
+				auto& node = m_nodes[best];
+				node.children[slot] = id;
+				node.generated |= static_cast<std::uint8_t>(1U << slot);
+				update_leaf(best);
+				if (node.generated == successors(best)) backup(best);
+				if (in_memory(best) == successors(best)) erase(best);
+				ans.counters.open_size(m_open.size());
+			}
+			ans.counters.load_factor = static_cast<double>(m_nodes.size() - m_free.size()) / m_max_nodes;
+		}
+		if (none != goal_id)
+		{
+			scoped_phase_t const phase{ ans.counters.phases, "trace" };
+			ans.solved = true;
+			ans.depth = ans.cost = m_nodes[goal_id].g;
+			for (auto id = goal_id; none != m_nodes[id].parent; id = m_nodes[id].parent)
+			{
+				auto const& parent = m_nodes[m_nodes[id].parent].board;
+				ans.moves.push_back(board_t<side_size>::direction(parent.empty_cell_index() - 1U, m_nodes[id].board.empty_cell_index() - 1U));
+			}
+			std::ranges::reverse(ans.moves);
+		}
+		return ans;
+	}
+private:
+	constexpr static std::uint32_t none = std::numeric_limits<std::uint32_t>::max();
+	constexpr static std::uint16_t infinity = std::numeric_limits<std::uint16_t>::max();
+	struct node_t
+	{
+		board_t<side_size> board;
+		std::uint32_t parent = none;
+		std::array<std::uint32_t, 4> children{ none, none, none, none };
+		std::uint16_t g = 0U;
+		std::uint16_t f = 0U;
+		//lowest f among the children dropped since their last generation
+		std::uint16_t forgotten = infinity;
+		//index of this node's move in the parent's move_table entry
+		std::uint8_t slot = 0U;
+		//move_table bits: the move back to the parent, and successors generated this round
+		std::uint8_t back = 0U;
+		std::uint8_t generated = 0U;
+		bool open = false;
+	};
+	//(f, ~g, id): the open list pops the deepest of the lowest f, the leaves the shallowest of the highest f
+	using key_t = std::tuple<std::uint16_t, std::uint16_t, std::uint32_t>;
+	using open_t = indexed_heap_t<key_t>;
+	using leaves_t = indexed_heap_t<key_t, std::greater<key_t>>;
+	key_t key(std::uint32_t const id) const noexcept
+	{
+		return { m_nodes[id].f, static_cast<std::uint16_t>(~m_nodes[id].g), id };
+	}
+	std::uint8_t successors(std::uint32_t const id) const noexcept
+	{
+		auto const& moves = board_t<side_size>::move_table[m_nodes[id].board.empty_cell_index() - 1U];
+		return static_cast<std::uint8_t>(((1U << moves.count) - 1U) & ~m_nodes[id].back);
+	}
+	std::uint8_t in_memory(std::uint32_t const id) const noexcept
+	{
+		std::uint8_t ans = 0U;
+		for (std::uint8_t slot = 0; slot < 4U; slot++)
+		{
+			if (none != m_nodes[id].children[slot]) ans |= static_cast<std::uint8_t>(1U << slot);
+		}
+		return ans;
+	}
+	//next successor to generate; once all were generated, the forgotten ones start over
+	std::uint8_t next_slot(std::uint32_t const id) noexcept
+	{
+		auto& node = m_nodes[id];
+		auto pending = static_cast<std::uint8_t>(successors(id) & ~node.generated);
+		if (0U == pending)
+		{
+			node.generated = in_memory(id);
+			node.forgotten = infinity;
+			pending = static_cast<std::uint8_t>(successors(id) & ~node.generated);
+		}
+		return static_cast<std::uint8_t>(std::countr_zero(pending));
+	}
+	std::uint32_t allocate(node_t const& node)
+	{
+		if (m_free.empty())
+		{
+			m_nodes.push_back(node);
+			return static_cast<std::uint32_t>(m_nodes.size() - 1U);
+		}
+		auto const id = m_free.back();
+		m_free.pop_back();
+		m_nodes[id] = node;
+		return id;
+	}
+	void insert(std::uint32_t const id)
+	{
+		m_open.push(id, key(id));
+		m_nodes[id].open = true;
+		update_leaf(id);
+	}
+	void erase(std::uint32_t const id)
+	{
+		m_open.erase(id);
+		m_nodes[id].open = false;
+		update_leaf(id);
+	}
+	//open nodes with a parent and no children in memory are the ones prune() may drop
+	void update_leaf(std::uint32_t const id)
+	{
+		if (m_leaves.contains(id)) m_leaves.erase(id);
+		if (m_nodes[id].open && none != m_nodes[id].parent && 0U == in_memory(id)) m_leaves.push(id, key(id));
+	}
+	void set_f(std::uint32_t const id, std::uint16_t const f)
+	{
+		bool const open = m_nodes[id].open;
+		if (open) erase(id);
+		m_nodes[id].f = f;
+		if (open) insert(id);
+	}
+	//with every successor generated, f is the best of the children and the forgotten ones
+	void backup(std::uint32_t id)
+	{
+		while (none != id && m_nodes[id].generated == successors(id))
+		{
+			auto f = m_nodes[id].forgotten;
+			for (auto const child : m_nodes[id].children)
+			{
+				if (none != child) f = std::min(f, m_nodes[child].f);
+			}
+			if (f == m_nodes[id].f) break;
+			set_f(id, f);
+			id = m_nodes[id].parent;
+		}
+	}
+	//drops the shallowest highest f leaf other than keep
+	bool prune(std::uint32_t const keep)
+	{
+		if (m_leaves.contains(keep)) m_leaves.erase(keep);
+		bool const found = !m_leaves.empty();
+		if (found)
+		{
+			auto const id = m_leaves.top();
+			auto const parent = m_nodes[id].parent;
+			erase(id);
+			m_nodes[parent].children[m_nodes[id].slot] = none;
+			m_nodes[parent].forgotten = std::min(m_nodes[parent].forgotten, m_nodes[id].f);
+			if (!m_nodes[parent].open) insert(parent);
+			else update_leaf(parent);
+			m_free.push_back(id);
+		}
+		update_leaf(keep);
+		return found;
+	}
+	heuristic_t m_heuristic;
+	std::size_t m_max_nodes;
+	std::vector<node_t> m_nodes;
+	std::vector<std::uint32_t> m_free;
+	open_t m_open;
+	leaves_t m_leaves;
+};
+
+template <std::uint8_t side_size, typename heuristic_t = manhattan_t>
+search_result_t smastar(board_t<side_size> const start, board_t<side_size> const goal, heuristic_t const& heuristic = {},
+	std::size_t const max_nodes = std::size_t{ 1 } << 22)
+{
+	return smastar_t<side_size, heuristic_t const&>{ heuristic, max_nodes }(start, goal);
+}
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//Closed list without a heap node per entry. Keys and values are appended to an
+//arena of fixed size blocks that are never moved or copied, so a 32 bit index, and
+//a reference from key() or value(), names a node for the whole search; clear()
+//drops them all at once and keeps the blocks. The slots are an open addressing
+//table over those indices with Robin Hood linear probing: an entry takes the slot
+//of any resident that is closer to its home, which keeps every probe sequence short
+//up to 7/8 occupancy. reserve() sizes the table ahead, so a search that stays within
+//its estimate never rehashes.
+template <typename key_t, typename value_t, typename hash_t = std::hash<key_t>>
+class closed_list_t
+{
+public:
+	using index_t = std::uint32_t;
+	constexpr static index_t none = std::numeric_limits<index_t>::max();
+	struct node_t
+	{
+		key_t key;
+		value_t value;
+	};
+
+	explicit closed_list_t(hash_t const& hash = {})
+		: m_hash{ hash }
+	{
+		rehash(min_slots);
+	}
+	//memory per node when the table is at its lowest load, for node estimates from a byte budget
+	constexpr static std::size_t bytes_per_node() noexcept
+	{
+		return sizeof(node_t) + sizeof(slot_t) * 16U / 7U;
+	}
+	//room for expected nodes without rehashing; blocks are only allocated once filled
+	void reserve(std::size_t const expected)
+	{
+		m_blocks.reserve((expected + block_size - 1U) / block_size);
+		if (slots_for(expected) > m_slots.size()) rehash(slots_for(expected));
+	}
+	void clear()
+	{
+		if (m_size * 8U < m_slots.size())
+		{
+			//mostly empty table, e.g. a short search after a long one: only visit the slots in use
+			m_used.clear();
+			for (std::size_t i = 0; i < m_size; i++)
+			{
+				m_used.push_back(locate(key(static_cast<index_t>(i)), m_hash(key(static_cast<index_t>(i)))));
+			}
+			for (auto const pos : m_used)
+			{
+				m_slots[pos] = slot_t{};
+			}
+		}
+		else
+		{
+			std::ranges::fill(m_slots, slot_t{});
+		}
+		m_size = 0U;
+	}
+	//the index of key's node and whether it was just added
+	std::pair<index_t, bool> try_emplace(key_t const& key, value_t const& value)
+	{
+		auto const hash = m_hash(key);
+		if (auto const pos = locate(key, hash); none != pos) return { m_slots[pos].index, false };
+		if (none == m_size) throw std::length_error("closed list exhausted 32 bit indices");
+		if ((m_size + 1U) * 8U > m_slots.size() * 7U) rehash(m_slots.size() * 2U);
+		auto const index = static_cast<index_t>(m_size);
+		if (index % block_size == 0U && index / block_size == m_blocks.size())
+		{
+			m_blocks.emplace_back(std::allocator<node_t>{}.allocate(block_size));
+		}
+		std::construct_at(&node(index), node_t{ key, value });
+		m_size++;
+		place(index, hash);
+		return { index, true };
+	}
+	index_t find(key_t const& key) const noexcept
+	{
+		auto const pos = locate(key, m_hash(key));
+		return none == pos ? none : m_slots[pos].index;
+	}
+	bool contains(key_t const& key) const noexcept
+	{
+		return none != find(key);
+	}
+	key_t const& key(index_t const index) const noexcept
+	{
+		return node(index).key;
+	}
+	value_t& value(index_t const index) noexcept
+	{
+		return node(index).value;
+	}
+	value_t const& value(index_t const index) const noexcept
+	{
+		return node(index).value;
+	}
+	std::size_t size() const noexcept
+	{
+		return m_size;
+	}
+	double load_factor() const noexcept
+	{
+		return static_cast<double>(m_size) / m_slots.size();
+	}
+private:
+	static_assert(std::is_trivially_destructible_v<node_t>, "clear() drops nodes without destroying them");
+	constexpr static std::size_t min_slots = 16;
+	constexpr static std::size_t block_bits = 14;
+	constexpr static std::size_t block_size = std::size_t{ 1 } << block_bits;
+	struct block_deleter_t
+	{
+		void operator()(node_t* const block) const noexcept
+		{
+			std::allocator<node_t>{}.deallocate(block, block_size);
+		}
+	};
+	//tag: the hash's top bits, so most mismatches never touch the arena
+	struct slot_t
+	{
+		index_t index = none;
+		std::uint16_t distance = 0U;
+		std::uint16_t tag = 0U;
+	};
+	static std::size_t slots_for(std::size_t const nodes) noexcept
+	{
+		return std::max(min_slots, std::bit_ceil(nodes * 8U / 7U + 1U));
+	}
+	static std::uint16_t tag(std::size_t const hash) noexcept
+	{
+		return static_cast<std::uint16_t>(static_cast<std::uint64_t>(hash) >> 48);
+	}
+	//slot holding key, or none; a resident closer to its home than we are to ours ends the search
+	std::size_t locate(key_t const& key, std::size_t const hash) const noexcept
+	{
+		auto const key_tag = tag(hash);
+		for (std::size_t pos = hash & m_mask, distance = 0;; pos = (pos + 1U) & m_mask, distance++)
+		{
+			auto const& slot = m_slots[pos];
+			if (none == slot.index || slot.distance < distance) return none;
+			if (slot.tag == key_tag && node(slot.index).key == key) return pos;
+		}
+	}
+	void place(index_t const index, std::size_t const hash) noexcept
+	{
+		slot_t incoming{ index, 0U, tag(hash) };
+		for (std::size_t pos = hash & m_mask;; pos = (pos + 1U) & m_mask, incoming.distance++)
+		{
+			auto& slot = m_slots[pos];
+			if (none == slot.index)
+			{
+				slot = incoming;
+				return;
+			}
+			if (slot.distance < incoming.distance) std::swap(slot, incoming);
+		}
+	}
+	void rehash(std::size_t const slot_count)
+	{
+		m_slots.assign(slot_count, slot_t{});
+		m_mask = slot_count - 1U;
+		for (index_t i = 0; i < m_size; i++)
+		{
+			place(i, m_hash(key(i)));
+		}
+	}
+	node_t& node(index_t const index) noexcept
+	{
+		return m_blocks[index >> block_bits].get()[index & (block_size - 1U)];
+	}
+	node_t const& node(index_t const index) const noexcept
+	{
+		return m_blocks[index >> block_bits].get()[index & (block_size - 1U)];
+	}
+	hash_t m_hash;
+	std::vector<std::unique_ptr<node_t, block_deleter_t>> m_blocks;
+	std::size_t m_size = 0U;
+	std::vector<slot_t> m_slots;
+	std::size_t m_mask = 0U;
+	std::vector<std::size_t> m_used;
+};
@@ -0,0 +1,249 @@
+#pragma once
+
+#include "npuzzle.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+//Layer and run files hold the packed cells of every board of one depth, sorted and unique,
+//as raw native endian 64 bit words.
+class state_reader_t
+{
+public:
+	explicit state_reader_t(std::filesystem::path const& path, std::size_t const buffer_size = 1U << 16)
+		: m_is{ path, std::ios::binary }, m_buffer(buffer_size)
+	{
+		if (!m_is) throw std::runtime_error("cannot open " + path.string());
+		fill();
+	}
+	bool empty() const noexcept
+	{
+		return m_pos == m_end;
+	}
+	std::uint64_t front() const noexcept
+	{
+		return m_buffer[m_pos];
+	}
+	void pop()
+	{
+		if (++m_pos == m_end) fill();
+	}
+private:
+	void fill()
+	{
+		m_is.read(reinterpret_cast<char*>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size() * sizeof(std::uint64_t)));
+		m_pos = 0U;
+		m_end = static_cast<std::size_t>(m_is.gcount()) / sizeof(std::uint64_t);
+	}
+	std::ifstream m_is;
+	std::vector<std::uint64_t> m_buffer;
+	std::size_t m_pos = 0U;
+	std::size_t m_end = 0U;
+};
+
+class state_writer_t
+{
+public:
+	explicit state_writer_t(std::filesystem::path const& path, std::size_t const buffer_size = 1U << 16)
+		: m_path{ path }, m_os{ path, std::ios::binary | std::ios::trunc }
+	{
+		if (!m_os) throw std::runtime_error("cannot create " + path.string());
+		m_buffer.reserve(buffer_size);
+	}
+	//callers flush() before the writer goes away
+	void push(std::uint64_t const state)
+	{
+		m_buffer.push_back(state);
+		m_count++;
+		if (m_buffer.size() == m_buffer.capacity()) flush();
+	}
+	void flush()
+	{
+		m_os.write(reinterpret_cast<char const*>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size() * sizeof(std::uint64_t)));
+		m_buffer.clear();
+		if (!m_os) throw std::runtime_error("cannot write " + m_path.string());
+	}
+	std::uint64_t count() const noexcept
+	{
+		return m_count;
+	}
+private:
+	std::filesystem::path m_path;
+	std::ofstream m_os;
+	std::vector<std::uint64_t> m_buffer;
+	std::uint64_t m_count = 0U;
+};
+
+struct external_bfs_options_t
+{
+	std::filesystem::path work_dir = std::filesystem::temp_directory_path() / "npuzzle_bfs";
+	std::size_t memory_budget = std::size_t{ 256 } << 20;
+	bool keep_layers = false;
+};
+
+//Breadth first enumeration with delayed duplicate detection. Children of layer d
+//are collected in memory up to the budget, then sorted and spilled as run files.
+//The runs are merged into layer d + 1, dropping everything already in layer d or
+//d - 1; in an undirected graph those are the only layers a child can repeat.
+//Memory is the child buffer plus at most fan_in read buffers, whatever the state count.
+template <std::uint8_t side_size>
+class external_bfs_t
+{
+	static_assert(1 == board_t<side_size>::word_count, "run files hold one word per board");
+public:
+	explicit external_bfs_t(external_bfs_options_t const& options = {})
+		: m_options{ options }
+	{
+	}
+	//writes "depth count" per completed layer to os and returns the layer sizes
+	std::vector<std::uint64_t> operator()(board_t<side_size> const root, std::ostream& os) const
+	{
+		std::filesystem::create_directories(m_options.work_dir);
+		{
+			state_writer_t writer{ layer_path(0U) };
+			writer.push(root.m_cells);
+			writer.flush();
+		}
+		std::vector<std::uint64_t> ans{ 1U };
+		os << 0 << ' ' << 1 << '\n' << std::flush;
+		for (std::size_t depth = 0;; depth++)
+		{
+			auto const count = merge(depth, expand(depth));
+			if (!m_options.keep_layers && depth > 0U) std::filesystem::remove(layer_path(depth - 1U));
+			if (0U == count)
+			{
+				std::filesystem::remove(layer_path(depth + 1U));
+				if (!m_options.keep_layers) std::filesystem::remove(layer_path(depth));
+				break;
+			}
+			ans.push_back(count);
+			os << depth + 1U << ' ' << count << '\n' << std::flush;
+		}
+		return ans;
+	}
+	std::filesystem::path layer_path(std::size_t const depth) const
+	{
+		return m_options.work_dir / ("layer_" + std::to_string(depth) + ".bin");
+	}
+private:
+	//runs merged at once; more are first merged in groups, keeping open files bounded
+	constexpr static std::size_t fan_in = 256;
+	std::filesystem::path run_path(std::size_t const pass, std::size_t const run) const
+	{
+		return m_options.work_dir / ("run_" + std::to_string(pass) + "_" + std::to_string(run) + ".tmp");
+	}
+	std::size_t buffer_size(std::size_t const readers) const noexcept
+	{
+		return std::clamp<std::size_t>(m_options.memory_budget / sizeof(std::uint64_t) / readers, 1U << 10, 1U << 16);
+	}
+	std::vector<std::filesystem::path> expand(std::size_t const depth) const
+	{
+		std::vector<std::filesystem::path> runs;
+		std::vector<std::uint64_t> children;
+		children.reserve(std::max<std::size_t>(1U << 10, m_options.memory_budget / sizeof(std::uint64_t)));
+		auto const spill = [&]()
+			{
+				std::ranges::sort(children);
+				auto const last = std::ranges::unique(children).begin();
+				runs.push_back(run_path(0U, runs.size()));
+				state_writer_t writer{ runs.back() };
+				for (auto it = children.begin(); it != last; ++it)
+				{
+					writer.push(*it);
+				}
+				writer.flush();
+				children.clear();
+			};
+		for (state_reader_t reader{ layer_path(depth) }; !reader.empty(); reader.pop())
+		{
+			for (auto const& child : board_t<side_size>::unpack(reader.front()).neighbors())
+			{
+				children.push_back(child.m_cells);
+				if (children.size() == children.capacity()) spill();
+			}
+		}
+		if (!children.empty()) spill();
+		return runs;
+	}
+	//k-way merge of sorted runs; every distinct state goes to sink once, in order
+	template <typename sink_t>
+	static void merge_runs(std::vector<std::filesystem::path> const& runs, std::size_t const buffer_size, sink_t&& sink)
+	{
+		std::vector<std::unique_ptr<state_reader_t>> readers;
+		for (auto const& run : runs)
+		{
+			readers.push_back(std::make_unique<state_reader_t>(run, buffer_size));
+		}
+		using entry_t = std::pair<std::uint64_t, std::size_t>;
+		std::priority_queue<entry_t, std::vector<entry_t>, std::greater<>> heads;
+		for (std::size_t i = 0; i < readers.size(); i++)
+		{
+			if (!readers[i]->empty()) heads.emplace(readers[i]->front(), i);
+		}
+		std::optional<std::uint64_t> last;
+		while (!heads.empty())
+		{
+			auto const [state, i] = heads.top();
+			heads.pop();
+			readers[i]->pop();
+			if (!readers[i]->empty()) heads.emplace(readers[i]->front(), i);
+			if (last == state) continue;
+			last = state;
+			sink(state);
+		}
+	}
+	std::uint64_t merge(std::size_t const depth, std::vector<std::filesystem::path> runs) const
+	{
+		for (std::size_t pass = 1; runs.size() > fan_in; pass++)
+		{
+			std::vector<std::filesystem::path> merged;
+			for (std::size_t first = 0; first < runs.size(); first += fan_in)
+			{
+				std::vector<std::filesystem::path> const group(runs.begin() + first, runs.begin() + std::min(first + fan_in, runs.size()));
+				merged.push_back(run_path(pass, merged.size()));
+				state_writer_t writer{ merged.back() };
+				merge_runs(group, buffer_size(group.size() + 1U), [&](std::uint64_t const state) { writer.push(state); });
+				writer.flush();
+				for (auto const& run : group)
+				{
+					std::filesystem::remove(run);
+				}
+			}
+			runs = std::move(merged);
+		}
+		auto const size = buffer_size(runs.size() + 3U);
+		std::optional<state_reader_t> current{ std::in_place, layer_path(depth), size };
+		std::optional<state_reader_t> previous;
+		if (depth > 0U) previous.emplace(layer_path(depth - 1U), size);
+		auto const seen = [](std::optional<state_reader_t>& layer, std::uint64_t const state)
+			{
+				if (!layer) return false;
+				while (!layer->empty() && layer->front() < state) layer->pop();
+				return !layer->empty() && layer->front() == state;
+			};
+		state_writer_t writer{ layer_path(depth + 1U), size };
+		merge_runs(runs, size, [&](std::uint64_t const state)
+			{
+				if (!seen(current, state) && !seen(previous, state)) writer.push(state);
+			});
+		writer.flush();
+		for (auto const& run : runs)
+		{
+			std::filesystem::remove(run);
+		}
+		return writer.count();
+	}
+	external_bfs_options_t m_options;
+};
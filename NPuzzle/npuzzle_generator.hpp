@@ -0,0 +1,108 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <ostream>
+#include <random>
+#include <string>
+#include <utility>
+
+#include "npuzzle.hpp"
+
+//Random instances against the goal {0, 1, ..., board_size - 1}, for test sets of millions
+//of boards: nothing allocates per board and the solvability test is one pass over it.
+template <std::uint8_t side_size>
+class instance_generator_t
+{
+public:
+	using board = board_t<side_size>;
+	constexpr static std::uint8_t board_size = board::board_size;
+
+	explicit instance_generator_t(std::uint64_t const seed)
+		: m_gen{ seed }
+	{
+		std::iota(m_tiles.begin(), m_tiles.end(), std::uint8_t{ 0 });
+	}
+	static board goal() noexcept
+	{
+		std::array<std::uint8_t, board_size> tiles;
+		std::iota(tiles.begin(), tiles.end(), std::uint8_t{ 0 });
+		return board{ tiles };
+	}
+	//Uniform over the solvable boards. A uniform permutation that is not solvable gets its
+	//first two tiles other than the blank swapped, which flips the inversion parity and
+	//keeps the blank, so every solvable board is drawn by exactly two permutations.
+	board random_solvable()
+	{
+		for (std::size_t i = board_size - 1U; i > 0U; i--)
+		{
+			std::swap(m_tiles[i], m_tiles[std::uniform_int_distribution<std::size_t>{ 0U, i }(m_gen)]);
+		}
+		if (board const ans{ m_tiles }; ans.solvable()) return ans;
+		auto const first = 0U == m_tiles[0] ? 1U : 0U;
+		auto const second = 0U == m_tiles[first + 1U] ? first + 2U : first + 1U;
+		std::swap(m_tiles[first], m_tiles[second]);
+		return board{ m_tiles };
+	}
+	//A walk of length moves from the goal that never takes back the move before. Its
+	//optimal solution is at most length moves long and of the same parity.
+	board random_walk(std::size_t const length)
+	{
+		auto ans = goal();
+		//0 based blank position before the last move, none at first
+		std::uint8_t previous = board_size;
+		for (std::size_t step = 0; step < length; step++)
+		{
+			auto const blank = static_cast<std::uint8_t>(ans.empty_cell_index() - 1U);
+			auto const& moves = board::move_table[blank];
+			auto const choices = moves.count - (board_size == previous ? 0U : 1U);
+			auto pick = std::uniform_int_distribution<std::size_t>{ 0U, choices - 1U }(m_gen);
+			std::uint8_t target = 0;
+			for (std::uint8_t i = 0; i < moves.count; i++)
+			{
+				if (moves.targets[i] == previous) continue;
+				if (0U == pick--)
+				{
+					target = moves.targets[i];
+					break;
+				}
+			}
+			ans = ans.move_empty(blank + 1U, target + 1U);
+			previous = blank;
+		}
+		return ans;
+	}
+private:
+	std::mt19937_64 m_gen;
+	std::array<std::uint8_t, board_size> m_tiles;
+};
+
+//count boards from make, one per line in the npuzzle --batch format, formatted into a
+//buffer that goes to os in large blocks
+template <std::uint8_t side_size, typename make_t>
+void write_instances(std::ostream& os, std::uint64_t const count, make_t&& make)
+{
+	constexpr std::size_t block = std::size_t{ 1 } << 16;
+	std::string buffer;
+	buffer.reserve(block + 4U * board_t<side_size>::board_size);
+	for (std::uint64_t i = 0; i < count; i++)
+	{
+		board_t<side_size> const instance = make();
+		for (std::uint8_t pos = 0; pos < board_t<side_size>::board_size; pos++)
+		{
+			auto const t = instance.tile(pos);
+			if (t >= 10U) buffer.push_back(static_cast<char>('0' + t / 10U));
+			buffer.push_back(static_cast<char>('0' + t % 10U));
+			buffer.push_back(pos + 1U == board_t<side_size>::board_size ? '\n' : ' ');
+		}
+		if (buffer.size() >= block)
+		{
+			os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+			buffer.clear();
+		}
+	}
+	os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
@@ -0,0 +1,400 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+struct manhattan_t
+{
+	template <typename board>
+	constexpr std::uint16_t operator()(board const& arg) const noexcept
+	{
+		return arg.heuristic();
+	}
+};
+
+//Manhattan distance to an arbitrary target, for searches running towards the start
+template <typename board>
+class manhattan_to_t
+{
+public:
+	explicit constexpr manhattan_to_t(board const& target) noexcept
+	{
+		for (std::uint8_t pos = 0; pos < board::board_size; pos++)
+		{
+			m_target_pos[target.tile(pos)] = pos;
+		}
+	}
+	constexpr std::uint16_t operator()(board const& arg) const noexcept
+	{
+		std::uint16_t ans = 0;
+		for (std::uint8_t pos = 0; pos < board::board_size; pos++)
+		{
+			auto const tile = arg.tile(pos);
+			if (0U == tile) continue;
+			ans += board::manhattan(m_target_pos[tile], pos);
+		}
+		return ans;
+	}
+private:
+	std::array<std::uint8_t, board::board_size> m_target_pos{};
+};
+
+class mapped_file_t
+{
+public:
+	explicit mapped_file_t(std::string const& path)
+	{
+		//the destructor does not run when the constructor throws
+		try
+		{
+			map(path);
+		}
+		catch (...)
+		{
+			release();
+			throw;
+		}
+	}
+	mapped_file_t(mapped_file_t const&) = delete;
+	mapped_file_t& operator=(mapped_file_t const&) = delete;
+	~mapped_file_t()
+	{
+		release();
+	}
+	std::uint8_t const* data() const noexcept
+	{
+		return m_data;
+	}
+	std::size_t size() const noexcept
+	{
+		return m_size;
+	}
+private:
+	void map(std::string const& path)
+	{
+#ifdef _WIN32
+		m_file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (INVALID_HANDLE_VALUE == m_file) throw std::runtime_error("cannot open " + path);
+		LARGE_INTEGER size;
+		if (!::GetFileSizeEx(m_file, &size)) throw std::runtime_error("cannot stat " + path);
+		m_size = static_cast<std::size_t>(size.QuadPart);
+		if (0U == m_size) throw std::runtime_error("empty file " + path);
+		m_mapping = ::CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (nullptr == m_mapping) throw std::runtime_error("cannot map " + path);
+		m_data = static_cast<std::uint8_t const*>(::MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+		m_file = ::open(path.c_str(), O_RDONLY);
+		if (m_file < 0) throw std::runtime_error("cannot open " + path);
+		struct stat st;
+		if (0 != ::fstat(m_file, &st)) throw std::runtime_error("cannot stat " + path);
+		m_size = static_cast<std::size_t>(st.st_size);
+		if (0U == m_size) throw std::runtime_error("empty file " + path);
+		void* const data = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, m_file, 0);
+		m_data = (MAP_FAILED == data) ? nullptr : static_cast<std::uint8_t const*>(data);
+#endif
+		if (nullptr == m_data) throw std::runtime_error("cannot map " + path);
+	}
+	void release() noexcept
+	{
+#ifdef _WIN32
+		if (m_data) ::UnmapViewOfFile(m_data);
+		if (m_mapping) ::CloseHandle(m_mapping);
+		if (INVALID_HANDLE_VALUE != m_file) ::CloseHandle(m_file);
+#else
+		if (m_data) ::munmap(const_cast<std::uint8_t*>(m_data), m_size);
+		if (m_file >= 0) ::close(m_file);
+#endif
+	}
+#ifdef _WIN32
+	HANDLE m_file = INVALID_HANDLE_VALUE;
+	HANDLE m_mapping = nullptr;
+#else
+	int m_file = -1;
+#endif
+	std::uint8_t const* m_data = nullptr;
+	std::size_t m_size = 0;
+};
+
+inline std::uint8_t pattern_database_side_size(std::string const& path)
+{
+	std::ifstream is{ path, std::ios::binary };
+	char header[5]{};
+	if (!is.read(header, sizeof(header)) || 0 != std::memcmp(header, "NPDB", 4))
+	{
+		throw std::runtime_error("malformed pattern database " + path);
+	}
+	return static_cast<std::uint8_t>(header[4]);
+}
+
+//Disjoint additive pattern databases for the goal {0, 1, ..., board_size - 1}.
+//File layout: "NPDB", side_size, pattern count, then per pattern its tile count
+//and tiles, then the tables in the same order, one byte per placement of the
+//pattern tiles. Only moves of pattern tiles are counted, so the sum over
+//disjoint patterns stays admissible.
+template <std::uint8_t side_size>
+class pattern_database_t
+{
+public:
+	constexpr static std::uint8_t board_size = side_size * side_size;
+	using pattern_t = std::vector<std::uint8_t>;
+	using placement_t = std::array<std::uint8_t, board_size>;
+
+	explicit pattern_database_t(std::string const& path)
+		: m_file{ path }
+	{
+		auto const* it = m_file.data();
+		auto const* const last = it + m_file.size();
+		auto const fail = [&path]() { throw std::runtime_error("malformed pattern database " + path); };
+		if (m_file.size() < 6 || 0 != std::memcmp(it, "NPDB", 4) || side_size != it[4]) fail();
+		std::uint8_t const pattern_count = it[5];
+		it += 6;
+		//the tiles of all patterns are distinct and none is the blank, or the sum of the
+		//tables is not admissible
+		std::array<bool, board_size> used{};
+		for (std::uint8_t i = 0; i < pattern_count; i++)
+		{
+			if (it == last || *it >= board_size || it + 1 + *it > last) fail();
+			for (auto const tile : std::span{ it + 1, *it })
+			{
+				if (0U == tile || tile >= board_size || used[tile]) fail();
+				used[tile] = true;
+			}
+			m_patterns.push_back({ pattern_t(it + 1, it + 1 + *it), nullptr });
+			it += 1 + *it;
+		}
+		for (auto& [tiles, table] : m_patterns)
+		{
+			if (static_cast<std::size_t>(last - it) < table_size(tiles.size())) fail();
+			table = it;
+			it += table_size(tiles.size());
+		}
+	}
+
+	template <typename board>
+	std::uint16_t operator()(board const& arg) const noexcept
+	{
+		placement_t where;
+		for (std::uint8_t pos = 0; pos < board_size; pos++)
+		{
+			where[arg.tile(pos)] = pos;
+		}
+		std::uint16_t ans = 0;
+		for (auto const& [tiles, table] : m_patterns)
+		{
+			ans += table[rank(tiles, where)];
+		}
+		return ans;
+	}
+
+	static void build(std::ostream& os, std::vector<pattern_t> const& partition)
+	{
+		os.write("NPDB", 4);
+		os.put(static_cast<char>(side_size));
+		os.put(static_cast<char>(partition.size()));
+		for (auto const& tiles : partition)
+		{
+			os.put(static_cast<char>(tiles.size()));
+			os.write(reinterpret_cast<char const*>(tiles.data()), tiles.size());
+		}
+		for (auto const& tiles : partition)
+		{
+			auto const table = build_table(tiles);
+			os.write(reinterpret_cast<char const*>(table.data()), table.size());
+		}
+	}
+
+	static std::vector<pattern_t> default_partition()
+	{
+		if constexpr (3 == side_size)
+		{
+			return { { 1, 2, 3, 4, 5, 6, 7, 8 } };
+		}
+		else if constexpr (4 == side_size)
+		{
+			return { { 1, 5, 6, 9, 10, 13 }, { 7, 8, 11, 12, 14, 15 }, { 2, 3, 4 } };
+		}
+		else
+		{
+			std::vector<pattern_t> ans;
+			for (std::uint8_t tile = 1; tile < board_size; tile++)
+			{
+				if (1 == tile % 6) ans.emplace_back();
+				ans.back().push_back(tile);
+			}
+			return ans;
+		}
+	}
+
+private:
+	static constexpr std::size_t table_size(std::size_t tile_count) noexcept
+	{
+		std::size_t ans = 1;
+		for (std::size_t i = 0; i < tile_count; i++)
+		{
+			ans *= board_size - i;
+		}
+		return ans;
+	}
+	//Mixed radix rank of the k-permutation of board positions held by the pattern tiles.
+	static std::size_t rank(pattern_t const& tiles, placement_t const& where) noexcept
+	{
+		std::size_t ans = 0;
+		std::uint32_t used = 0;
+		for (std::size_t i = 0; i < tiles.size(); i++)
+		{
+			auto const pos = where[tiles[i]];
+			auto const digit = pos - std::popcount(used & ((1U << pos) - 1U));
+			ans = ans * (board_size - i) + digit;
+			used |= 1U << pos;
+		}
+		return ans;
+	}
+	static void unrank(std::size_t index, std::size_t tile_count, std::uint8_t* positions) noexcept
+	{
+		std::array<std::uint8_t, board_size> digits;
+		for (auto i = tile_count; i-- > 0;)
+		{
+			digits[i] = static_cast<std::uint8_t>(index % (board_size - i));
+			index /= board_size - i;
+		}
+		std::uint32_t used = 0;
+		for (std::size_t i = 0; i < tile_count; i++)
+		{
+			std::uint8_t pos = 0;
+			for (std::uint8_t free = 0;; pos++)
+			{
+				if (used & (1U << pos)) continue;
+				if (free++ == digits[i]) break;
+			}
+			positions[i] = pos;
+			used |= 1U << pos;
+		}
+	}
+	//one bit per board cell
+	using cells_t = std::conditional_t<board_size <= 16, std::uint16_t, std::uint32_t>;
+	constexpr static cells_t column(std::uint8_t const col) noexcept
+	{
+		cells_t ans = 0;
+		for (std::uint8_t row = 0; row < side_size; row++)
+		{
+			ans |= cells_t{ 1 } << (row * side_size + col);
+		}
+		return ans;
+	}
+	//the cells the blank reaches from cell without moving a pattern tile
+	static cells_t region(cells_t const free, std::uint8_t const cell) noexcept
+	{
+		constexpr cells_t first_column = column(0), last_column = column(side_size - 1);
+		cells_t ans = cells_t{ 1 } << cell;
+		for (;;)
+		{
+			auto const grown = static_cast<cells_t>((ans | (ans << side_size) | (ans >> side_size)
+				| ((ans & ~last_column) << 1) | ((ans & ~first_column) >> 1)) & free);
+			if (grown == ans) return ans;
+			ans = grown;
+		}
+	}
+	//BFS backwards from the goal over (pattern placement, blank region). The blank moves
+	//over other tiles for free, so every cell it reaches that way shares one state, and
+	//only moves of pattern tiles cost. visited keeps one bit per (placement, blank cell),
+	//and the first layer that reaches a placement is its distance.
+	static std::vector<std::uint8_t> build_table(pattern_t const& tiles)
+	{
+		auto const entries = table_size(tiles.size());
+		constexpr std::uint8_t unknown = std::numeric_limits<std::uint8_t>::max();
+		constexpr cells_t all_cells = static_cast<cells_t>((std::uint64_t{ 1 } << board_size) - 1U);
+		std::vector<std::uint8_t> ans(entries, unknown);
+		std::vector<cells_t> visited(entries);
+		placement_t where;
+		for (std::uint8_t tile = 0; tile < board_size; tile++)
+		{
+			where[tile] = tile;
+		}
+		std::array<std::uint8_t, board_size> positions;
+		auto const occupied = [&tiles, &positions]()
+			{
+				cells_t ans = 0;
+				for (std::size_t i = 0; i < tiles.size(); i++)
+				{
+					ans |= cells_t{ 1 } << positions[i];
+				}
+				return ans;
+			};
+		std::vector<std::uint64_t> frontier, next;
+		auto const root = rank(tiles, where);
+		for (std::size_t i = 0; i < tiles.size(); i++)
+		{
+			positions[i] = tiles[i];
+		}
+		ans[root] = 0;
+		visited[root] = region(all_cells & ~occupied(), 0);
+		frontier.push_back(root * board_size);
+		for (std::uint8_t depth = 1; !frontier.empty(); depth++)
+		{
+			for (auto const state : frontier)
+			{
+				auto const index = state / board_size;
+				unrank(index, tiles.size(), positions.data());
+				auto const pattern = occupied();
+				for (auto cells = region(all_cells & ~pattern, state % board_size); 0U != cells; cells &= cells - 1U)
+				{
+					auto const blank = static_cast<std::uint8_t>(std::countr_zero(cells));
+					auto const push = [&](std::uint8_t const from)
+						{
+							if (0U == (pattern & (cells_t{ 1 } << from))) return;
+							auto* const moved = std::find(positions.data(), positions.data() + tiles.size(), from);
+							*moved = blank;
+							for (std::size_t i = 0; i < tiles.size(); i++)
+							{
+								where[tiles[i]] = positions[i];
+							}
+							auto const child = rank(tiles, where);
+							if (0U == (visited[child] & (cells_t{ 1 } << from)))
+							{
+								visited[child] |= region(all_cells & ~occupied(), from);
+								ans[child] = std::min(ans[child], depth);
+								next.push_back(child * board_size + from);
+							}
+							*moved = from;
+						};
+					auto const [row, col] = std::div(blank, side_size);
+					if (col > 0) push(blank - 1);
+					if (col + 1 < side_size) push(blank + 1);
+					if (row > 0) push(blank - side_size);
+					if (row + 1 < side_size) push(blank + side_size);
+				}
+			}
+			frontier.swap(next);
+			next.clear();
+		}
+		return ans;
+	}
+
+	mapped_file_t m_file;
+	std::vector<std::pair<pattern_t, std::uint8_t const*>> m_patterns;
+};
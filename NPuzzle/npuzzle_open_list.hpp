@@ -0,0 +1,222 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+//Open lists keyed by small integer f = g + h. Both pop the lowest f first and,
+//among equal f, the deepest g first.
+
+template <typename value_t>
+class heap_open_list_t
+{
+public:
+	void push(std::uint16_t const f, std::uint16_t const g, value_t const value)
+	{
+		m_heap.emplace(f, g, value);
+	}
+	std::pair<std::uint16_t, value_t> pop()
+	{
+		auto const [f, g, value] = m_heap.top();
+		m_heap.pop();
+		return { f, value };
+	}
+	bool empty() const noexcept
+	{
+		return m_heap.empty();
+	}
+	std::size_t size() const noexcept
+	{
+		return m_heap.size();
+	}
+	void clear()
+	{
+		m_heap = {};
+	}
+private:
+	using entry_t = std::tuple<std::uint16_t, std::uint16_t, value_t>;
+	struct cmp_t
+	{
+		bool operator()(entry_t const& lhs, entry_t const& rhs) const noexcept
+		{
+			if (std::get<0>(lhs) != std::get<0>(rhs)) return std::get<0>(lhs) > std::get<0>(rhs);
+			return std::get<1>(lhs) < std::get<1>(rhs);
+		}
+	};
+	std::priority_queue<entry_t, std::deque<entry_t>, cmp_t> m_heap;
+};
+
+//One bucket per f, one LIFO stack per g inside a bucket. Stacks above the
+//deepest g pushed so far are skipped by a per-bucket top index, so push and
+//pop are O(1) amortized as long as f does not decrease (consistent heuristics).
+//clear() keeps every allocated stack for the next search.
+template <typename value_t>
+class bucket_open_list_t
+{
+public:
+	void push(std::uint16_t const f, std::uint16_t const g, value_t const value)
+	{
+		if (f >= m_buckets.size()) m_buckets.resize(f + 1U);
+		auto& bucket = m_buckets[f];
+		if (g >= bucket.stacks.size()) bucket.stacks.resize(g + 1U);
+		bucket.stacks[g].push_back(value);
+		bucket.top = std::max<std::size_t>(bucket.top, g + 1U);
+		bucket.count++;
+		if (f < m_min_f) m_min_f = f;
+		m_size++;
+	}
+	std::pair<std::uint16_t, value_t> pop()
+	{
+		assert(!empty());
+		while (0U == m_buckets[m_min_f].count) m_min_f++;
+		auto& bucket = m_buckets[m_min_f];
+		while (bucket.stacks[bucket.top - 1U].empty()) bucket.top--;
+		auto& stack = bucket.stacks[bucket.top - 1U];
+		auto const value = stack.back();
+		stack.pop_back();
+		bucket.count--;
+		m_size--;
+		return { static_cast<std::uint16_t>(m_min_f), value };
+	}
+	bool empty() const noexcept
+	{
+		return 0U == m_size;
+	}
+	std::size_t size() const noexcept
+	{
+		return m_size;
+	}
+	void clear() noexcept
+	{
+		for (auto& bucket : m_buckets)
+		{
+			for (auto& stack : bucket.stacks)
+			{
+				stack.clear();
+			}
+			bucket.top = 0U;
+			bucket.count = 0U;
+		}
+		m_min_f = 0U;
+		m_size = 0U;
+	}
+private:
+	struct bucket_t
+	{
+		std::vector<std::vector<value_t>> stacks;
+		std::size_t top = 0U;
+		std::size_t count = 0U;
+	};
+	std::vector<bucket_t> m_buckets;
+	std::size_t m_min_f = 0U;
+	std::size_t m_size = 0U;
+};
+
+//Binary heap over small integer ids that remembers where every id sits, so any
+//id can leave in O(log n). top() is the id whose key compare_t puts first.
+template <typename key_t, typename compare_t = std::less<key_t>>
+class indexed_heap_t
+{
+public:
+	//memory per id once reserve() made room for it
+	constexpr static std::size_t bytes_per_id() noexcept
+	{
+		return sizeof(entry_t) + sizeof(std::uint32_t);
+	}
+	void reserve(std::size_t const capacity)
+	{
+		m_heap.reserve(capacity);
+		m_position.reserve(capacity);
+	}
+	void push(std::uint32_t const id, key_t const& key)
+	{
+		assert(!contains(id));
+		if (id >= m_position.size()) m_position.resize(id + 1U, none);
+		m_position[id] = static_cast<std::uint32_t>(m_heap.size());
+		m_heap.push_back({ key, id });
+		sift_up(m_heap.size() - 1U);
+	}
+	void erase(std::uint32_t const id)
+	{
+		assert(contains(id));
+		std::size_t const pos = std::exchange(m_position[id], none);
+		auto const last = m_heap.back();
+		m_heap.pop_back();
+		if (pos == m_heap.size()) return;
+		m_heap[pos] = last;
+		m_position[last.id] = static_cast<std::uint32_t>(pos);
+		sift_up(pos);
+		sift_down(m_position[last.id]);
+	}
+	bool contains(std::uint32_t const id) const noexcept
+	{
+		return id < m_position.size() && none != m_position[id];
+	}
+	std::uint32_t top() const noexcept
+	{
+		assert(!empty());
+		return m_heap.front().id;
+	}
+	bool empty() const noexcept
+	{
+		return m_heap.empty();
+	}
+	std::size_t size() const noexcept
+	{
+		return m_heap.size();
+	}
+	void clear() noexcept
+	{
+		for (auto const& entry : m_heap)
+		{
+			m_position[entry.id] = none;
+		}
+		m_heap.clear();
+	}
+private:
+	constexpr static std::uint32_t none = std::numeric_limits<std::uint32_t>::max();
+	struct entry_t
+	{
+		key_t key;
+		std::uint32_t id;
+	};
+	void swap_entries(std::size_t const lhs, std::size_t const rhs) noexcept
+	{
+		std::swap(m_heap[lhs], m_heap[rhs]);
+		m_position[m_heap[lhs].id] = static_cast<std::uint32_t>(lhs);
+		m_position[m_heap[rhs].id] = static_cast<std::uint32_t>(rhs);
+	}
+	void sift_up(std::size_t pos) noexcept
+	{
+		while (pos > 0U && m_compare(m_heap[pos].key, m_heap[(pos - 1U) / 2U].key))
+		{
+			swap_entries(pos, (pos - 1U) / 2U);
+			pos = (pos - 1U) / 2U;
+		}
+	}
+	void sift_down(std::size_t pos) noexcept
+	{
+		for (;;)
+		{
+			auto first = pos;
+			for (auto const child : { 2U * pos + 1U, 2U * pos + 2U })
+			{
+				if (child < m_heap.size() && m_compare(m_heap[child].key, m_heap[first].key)) first = child;
+			}
+			if (first == pos) return;
+			swap_entries(pos, first);
+			pos = first;
+		}
+	}
+	std::vector<entry_t> m_heap;
+	std::vector<std::uint32_t> m_position;
+	[[no_unique_address]] compare_t m_compare;
+};
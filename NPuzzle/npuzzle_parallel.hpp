@@ -0,0 +1,262 @@
+#pragma once
+
+#include "npuzzle.hpp"
+#include "npuzzle_closed_list.hpp"
+#include "npuzzle_heuristic.hpp"
+#include "npuzzle_open_list.hpp"
+#include "npuzzle_solver.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+template <std::uint8_t side_size>
+class zobrist_t
+{
+public:
+	constexpr static std::uint8_t board_size = board_t<side_size>::board_size;
+	zobrist_t()
+	{
+		std::mt19937_64 gen{ 0x9e3779b97f4a7c15ULL };
+		for (auto& keys : m_keys)
+		{
+			for (auto& key : keys)
+			{
+				key = gen();
+			}
+		}
+	}
+	std::uint64_t operator()(board_t<side_size> const& arg) const noexcept
+	{
+		std::uint64_t ans = 0;
+		for (std::uint8_t pos = 0; pos < board_size; pos++)
+		{
+			ans ^= m_keys[pos][arg.tile(pos)];
+		}
+		return ans;
+	}
+	//tile slides from -> to, the blank goes the other way
+	std::uint64_t move(std::uint64_t const hash, std::uint8_t const tile, std::uint8_t const from, std::uint8_t const to) const noexcept
+	{
+		return hash ^ m_keys[from][tile] ^ m_keys[to][tile] ^ m_keys[to][0] ^ m_keys[from][0];
+	}
+private:
+	std::array<std::array<std::uint64_t, board_size>, board_size> m_keys;
+};
+
+//Hash distributed A*: every state is owned by the worker zobrist(state) % thread_count.
+//Children are batched per owner and delivered through mutex protected inboxes.
+//work counts active workers plus undelivered batches; it only grows while it is
+//positive, so reaching zero is a stable termination condition.
+template <std::uint8_t side_size, typename heuristic_t = manhattan_t>
+class hdastar_t
+{
+public:
+	//expected: closed list nodes of all workers together
+	explicit hdastar_t(heuristic_t const& heuristic = {}, unsigned const thread_count = std::max(1U, std::thread::hardware_concurrency()),
+		std::size_t const expected = expected_nodes<side_size>())
+		: m_heuristic{ heuristic }, m_thread_count{ thread_count }, m_expected{ expected }
+	{
+	}
+	search_result_t operator()(board_t<side_size> const start, board_t<side_size> const goal) const
+	{
+		auto const& heuristic = m_heuristic;
+		auto const thread_count = m_thread_count;
+		struct message_t
+		{
+			board_t<side_size> board;
+			trail_t trail;
+			std::uint64_t hash;
+		};
+		struct inbox_t
+		{
+			std::mutex mutex;
+			std::vector<message_t> messages;
+			std::size_t batches = 0;
+			std::atomic<bool> pending = false;
+		};
+		constexpr std::size_t batch_size = 64;
+		constexpr std::uint16_t none = std::numeric_limits<std::uint16_t>::max();
+		zobrist_t<side_size> const zobrist;
+		std::vector<std::unique_ptr<inbox_t>> inboxes;
+		std::vector<closed_list_t<board_t<side_size>, trail_t>> closed_lists(thread_count);
+		for (unsigned i = 0; i < thread_count; i++)
+		{
+			inboxes.push_back(std::make_unique<inbox_t>());
+		}
+		std::atomic<std::int64_t> work = thread_count + 1;
+		std::atomic<std::uint16_t> best = none;
+		std::atomic<std::uint16_t> max_depth = 0;
+		//every worker counts on its own and adds its totals here once it is done
+		search_result_t ans;
+		std::mutex counters_mutex;
+		auto const start_hash = zobrist(start);
+		inboxes[start_hash % thread_count]->messages.push_back({ start, trail_t{}, start_hash });
+		inboxes[start_hash % thread_count]->batches = 1;
+		inboxes[start_hash % thread_count]->pending = true;
+
+		auto worker = [&](unsigned const self)
+			{
+				auto& closed = closed_lists[self];
+				closed.reserve(m_expected / thread_count);
+				bucket_open_list_t<message_t> open;
+				std::vector<std::vector<message_t>> outboxes(thread_count);
+				std::vector<message_t> received;
+				search_counters_t counters;
+				std::uint16_t deepest = 0;
+				bool active = true;
+				auto const insert = [&](message_t const& message)
+					{
+						std::uint16_t const depth = message.trail.depth;
+						std::uint16_t const f = depth + heuristic(message.board);
+						if (f >= best.load(std::memory_order_relaxed)) return;
+						auto const [index, inserted] = closed.try_emplace(message.board, message.trail);
+						if (!inserted)
+						{
+							if (closed.value(index).depth <= depth)
+							{
+								counters.duplicates++;
+								return;
+							}
+							closed.value(index) = message.trail;
+						}
+						open.push(f, depth, message);
+					};
+				auto const flush = [&](unsigned const owner)
+					{
+						auto& outbox = outboxes[owner];
+						if (outbox.empty()) return;
+						work.fetch_add(1);
+						auto& inbox = *inboxes[owner];
+						{
+							std::lock_guard g{ inbox.mutex };
+							inbox.messages.insert(inbox.messages.end(), outbox.begin(), outbox.end());
+							inbox.batches++;
+							inbox.pending.store(true, std::memory_order_release);
+						}
+						outbox.clear();
+					};
+				for (auto& inbox = *inboxes[self];;)
+				{
+					if (inbox.pending.load(std::memory_order_acquire))
+					{
+						std::size_t batches;
+						{
+							std::lock_guard g{ inbox.mutex };
+							received.swap(inbox.messages);
+							batches = std::exchange(inbox.batches, 0U);
+							inbox.pending.store(false, std::memory_order_relaxed);
+						}
+						if (!active)
+						{
+							work.fetch_add(1);
+							active = true;
+						}
+						for (auto const& message : received)
+						{
+							insert(message);
+						}
+						received.clear();
+						work.fetch_sub(static_cast<std::int64_t>(batches));
+					}
+					if (!open.empty())
+					{
+						auto const [f, node] = open.pop();
+						std::uint16_t const depth = node.trail.depth;
+						if (closed.value(closed.find(node.board)).depth < depth) continue;
+						if (f >= best.load(std::memory_order_relaxed)) continue;
+						if (node.board == goal)
+						{
+							for (auto current = best.load(); depth < current && !best.compare_exchange_weak(current, depth););
+							continue;
+						}
+						counters.expand(depth);
+						deepest = std::max<std::uint16_t>(deepest, depth + 1U);
+						auto const empty_idx = node.board.empty_cell_index();
+						for (auto const& neighbor : node.board.neighbors())
+						{
+							auto const tile = neighbor.tile(empty_idx - 1U);
+							auto const hash = zobrist.move(node.hash, tile, neighbor.empty_cell_index() - 1U, empty_idx - 1U);
+							trail_t const trail{ static_cast<std::uint16_t>(depth + 1U), board_t<side_size>::direction(empty_idx - 1U, neighbor.empty_cell_index() - 1U) };
+							message_t const child{ neighbor, trail, hash };
+							counters.generations++;
+							auto const owner = static_cast<unsigned>(hash % thread_count);
+							if (owner == self)
+							{
+								insert(child);
+								continue;
+							}
+							outboxes[owner].push_back(child);
+							if (outboxes[owner].size() >= batch_size) flush(owner);
+						}
+						counters.open_size(open.size());
+						continue;
+					}
+					for (unsigned owner = 0; owner < thread_count; owner++)
+					{
+						flush(owner);
+					}
+					if (active)
+					{
+						active = false;
+						work.fetch_sub(1);
+					}
+					if (0 == work.load()) break;
+					std::this_thread::yield();
+				}
+				counters.load_factor = closed.load_factor();
+				{
+					std::lock_guard g{ counters_mutex };
+					ans.counters.merge(counters);
+				}
+				for (auto current = max_depth.load(); deepest > current && !max_depth.compare_exchange_weak(current, deepest););
+			};
+		{
+			scoped_phase_t const phase{ ans.counters.phases, "search" };
+			std::vector<std::jthread> tasks;
+			tasks.reserve(thread_count);
+			for (unsigned i = 0; i < thread_count; i++)
+			{
+				tasks.emplace_back(worker, i);
+			}
+		}
+		//the root
+		ans.counters.generations++;
+		ans.solved = none != best;
+		ans.depth = ans.cost = ans.solved ? best.load() : 0U;
+		ans.max_depth = max_depth;
+		if (ans.solved)
+		{
+			scoped_phase_t const phase{ ans.counters.phases, "trace" };
+			//every board's trail lives with its owner
+			for (auto node = goal;;)
+			{
+				auto const& closed = closed_lists[zobrist(node) % thread_count];
+				trail_t const trail = closed.value(closed.find(node));
+				if (0U == trail.depth) break;
+				ans.moves.push_back(trail.move());
+				node = node.apply(opposite(trail.move()));
+			}
+			std::ranges::reverse(ans.moves);
+		}
+		return ans;
+	}
+private:
+	heuristic_t m_heuristic;
+	unsigned m_thread_count;
+	std::size_t m_expected;
+};
+
+template <std::uint8_t side_size, typename heuristic_t = manhattan_t>
+search_result_t hdastar(board_t<side_size> const start, board_t<side_size> const goal, heuristic_t const& heuristic = {},
+	unsigned const thread_count = std::max(1U, std::thread::hardware_concurrency()))
+{
+	return hdastar_t<side_size, heuristic_t const&>{ heuristic, thread_count }(start, goal);
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "npuzzle.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+//Perfect hash of the boards of one parity class onto [0, state_count).
+//rank = blank position * (m! / 2) + Myrvold-Ruskey rank of the m = board_size - 1
+//tiles read in row order. The rank's last digit only orders the final two
+//elements, which the parity class already decides, so it is dropped.
+template <std::uint8_t side_size>
+class permutation_rank_t
+{
+	static_assert(side_size <= 4, "ranks of larger boards do not fit into 64 bits");
+public:
+	using board = board_t<side_size>;
+	constexpr static std::uint8_t tile_count = board::board_size - 1U;
+	constexpr static std::uint64_t half_factorial = []()
+		{
+			std::uint64_t ans = 1U;
+			for (std::uint64_t i = 3; i <= tile_count; i++)
+			{
+				ans *= i;
+			}
+			return ans;
+		}();
+	constexpr static std::uint64_t state_count = board::board_size * half_factorial;
+
+	constexpr static std::uint64_t rank(board const& arg) noexcept
+	{
+		std::array<std::uint8_t, tile_count> perm{}, inverse{};
+		for (std::uint8_t pos = 0, i = 0; pos < board::board_size; pos++)
+		{
+			auto const tile = arg.tile(pos);
+			if (0U == tile) continue;
+			perm[i] = tile - 1U;
+			inverse[tile - 1U] = i;
+			i++;
+		}
+		std::array<std::uint8_t, tile_count> digits{};
+		for (std::uint8_t i = tile_count; i > 2U; i--)
+		{
+			auto const s = perm[i - 1U];
+			digits[i - 1U] = s;
+			std::swap(perm[i - 1U], perm[inverse[i - 1U]]);
+			std::swap(inverse[s], inverse[i - 1U]);
+		}
+		std::uint64_t ans = 0U;
+		for (std::uint8_t i = 3; i <= tile_count; i++)
+		{
+			ans = ans * i + digits[i - 1U];
+		}
+		return (arg.empty_cell_index() - 1U) * half_factorial + ans;
+	}
+	//solvable selects the parity class, against the goal {0, 1, ..., board_size - 1}
+	constexpr static board unrank(std::uint64_t r, bool const solvable = true) noexcept
+	{
+		std::uint8_t const blank = static_cast<std::uint8_t>(r / half_factorial);
+		r %= half_factorial;
+		std::array<std::uint8_t, tile_count> perm{};
+		for (std::uint8_t i = 0; i < tile_count; i++)
+		{
+			perm[i] = i;
+		}
+		for (std::uint8_t i = tile_count; i > 2U; i--)
+		{
+			std::swap(perm[i - 1U], perm[r % i]);
+			r /= i;
+		}
+		bool parity = false;
+		if constexpr (0 == side_size % 2)
+		{
+			parity = 1 == (blank / side_size) % 2;
+		}
+		if (odd(perm) != (parity != !solvable)) std::swap(perm[0], perm[1]);
+		std::array<std::uint8_t, board::board_size> cells{};
+		for (std::uint8_t pos = 0, i = 0; pos < board::board_size; pos++)
+		{
+			cells[pos] = pos == blank ? 0U : perm[i++] + 1U;
+		}
+		return board{ cells };
+	}
+private:
+	constexpr static bool odd(std::array<std::uint8_t, tile_count> const& perm) noexcept
+	{
+		std::array<bool, tile_count> seen{};
+		std::uint8_t cycles = 0;
+		for (std::uint8_t i = 0; i < tile_count; i++)
+		{
+			if (seen[i]) continue;
+			cycles++;
+			for (auto j = i; !seen[j]; j = perm[j])
+			{
+				seen[j] = true;
+			}
+		}
+		return 1 == (tile_count - cycles) % 2;
+	}
+};
+
+//Flat array of bits wide unsigned entries, all zero initially.
+template <std::uint8_t bits>
+class packed_array_t
+{
+public:
+	static_assert(0 == 64 % bits, "entries must not straddle words");
+	constexpr static std::uint64_t entry_mask = (1ULL << bits) - 1U;
+	void assign(std::uint64_t const size)
+	{
+		m_words.assign((size * bits + 63U) / 64U, 0U);
+	}
+	std::uint8_t get(std::uint64_t const i) const noexcept
+	{
+		return static_cast<std::uint8_t>((m_words[i * bits / 64U] >> (i * bits % 64U)) & entry_mask);
+	}
+	void set(std::uint64_t const i, std::uint8_t const value) noexcept
+	{
+		auto& word = m_words[i * bits / 64U];
+		auto const shift = i * bits % 64U;
+		word = (word & ~(entry_mask << shift)) | (static_cast<std::uint64_t>(value) << shift);
+	}
+	std::size_t memory() const noexcept
+	{
+		return m_words.size() * sizeof(std::uint64_t);
+	}
+private:
+	std::vector<std::uint64_t> m_words;
+};
@@ -1,41 +1,447 @@
 #pragma once
 
+#include "../Common/counters.hpp"
 #include "npuzzle.hpp"
+#include "npuzzle_closed_list.hpp"
+#include "npuzzle_heuristic.hpp"
+#include "npuzzle_open_list.hpp"
+#include "npuzzle_rank.hpp"
 
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
 #include <deque>
-#include <queue>
+#include <limits>
+#include <ostream>
 //#include <stack>
-#include <unordered_map>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
+struct search_result_t
+{
+	bool solved = false;
+	std::uint16_t depth = 0;
+	std::uint16_t max_depth = 0;
+	std::uint16_t cost = 0;
+	std::vector<move_t> moves;
+	search_counters_t counters;
+	friend std::ostream& operator<<(std::ostream& os, search_result_t const& arg)
+	{
+		os << "solved           " << (arg.solved ? "true" : "false") << '\n';
+		os << "expansions       " << arg.counters.expansions << '\n';
+		os << "generations      " << arg.counters.generations << '\n';
+		os << "depth            " << arg.depth << '\n';
+		os << "max depth        " << arg.max_depth << '\n';
+		os << "cost             " << arg.cost << '\n';
+		os << "moves            ";
+		for (auto const move : arg.moves)
+		{
+			os << move;
+		}
+		os << "\ncounters         ";
+		arg.counters.write_json(os);
+		return os << '\n';
+	}
+};
+
+//What a closed list keeps per board: its depth and the 2 bit blank move that
+//reached it. The parent is that move undone, so no pointers are stored.
+struct trail_t
+{
+	constexpr static std::uint16_t max_depth = std::numeric_limits<std::uint16_t>::max();
+	std::uint16_t depth;
+	std::uint8_t last_move : 2;
+	constexpr trail_t(std::uint16_t const depth = 0U, move_t const move = move_t::left) noexcept
+		: depth{ depth }, last_move{ static_cast<std::uint8_t>(move) }
+	{
+	}
+	constexpr move_t move() const noexcept
+	{
+		return static_cast<move_t>(last_move);
+	}
+};
+
+//Closed list nodes a search reserves before it starts, from the caller's node budget
+//when it has one. The 8-puzzle never needs more than its parity class; larger boards
+//start from 2^18 nodes without a budget and grow from there.
+template <std::uint8_t side_size>
+constexpr std::size_t expected_nodes(std::size_t const budget = 0U) noexcept
+{
+	if constexpr (3 == side_size)
+	{
+		constexpr std::size_t parity_class = 181440U;
+		return 0U == budget ? parity_class : std::min(budget, parity_class);
+	}
+	else
+	{
+		return 0U == budget ? std::size_t{ 1 } << 18 : budget;
+	}
+}
+
+//Replays the stored moves backwards from node to the depth 0 root.
+template <typename history_t, typename board>
+std::vector<move_t> trace_moves(history_t const& history, board node)
+{
+	std::vector<move_t> ans;
+	for (trail_t trail = history.value(history.find(node)); 0U != trail.depth; trail = history.value(history.find(node)))
+	{
+		ans.push_back(trail.move());
+		node = node.apply(opposite(trail.move()));
+	}
+	std::ranges::reverse(ans);
+	return ans;
+}
+
+//Closed lists of the uninformed searches: reset(root), insert(board, trail) that
+//reports whether the board is new, and the moves from the root to a stored board.
+template <std::uint8_t side_size>
+class hashed_history_t
+{
+public:
+	void reset(board_t<side_size> const root)
+	{
+		m_nodes.clear();
+		m_nodes.reserve(expected_nodes<side_size>());
+		m_nodes.try_emplace(root, trail_t{});
+	}
+	bool insert(board_t<side_size> const board, trail_t const trail)
+	{
+		return m_nodes.try_emplace(board, trail).second;
+	}
+	std::vector<move_t> moves(board_t<side_size> const board) const
+	{
+		return trace_moves(m_nodes, board);
+	}
+	std::size_t size() const noexcept
+	{
+		return m_nodes.size();
+	}
+	double load_factor() const noexcept
+	{
+		return m_nodes.load_factor();
+	}
+private:
+	closed_list_t<board_t<side_size>, trail_t> m_nodes;
+};
+
+//One visited bit and one 2 bit last move per rank of the start's parity class,
+//about 3 bits per state instead of a heap node per board. Only for boards whose
+//whole class fits in memory.
 template <std::uint8_t side_size>
-int solve(board_t<side_size> const start, board_t<side_size> const target)
+class dense_history_t
+{
+public:
+	using ranking_t = permutation_rank_t<side_size>;
+	static_assert(ranking_t::state_count <= (1ULL << 32), "state space too large for a flat table");
+	void reset(board_t<side_size> const root)
+	{
+		m_visited.assign(ranking_t::state_count);
+		m_moves.assign(ranking_t::state_count);
+		m_root = root;
+		m_size = 0U;
+		insert(root, trail_t{});
+	}
+	bool insert(board_t<side_size> const board, trail_t const trail)
+	{
+		auto const rank = ranking_t::rank(board);
+		if (0U != m_visited.get(rank)) return false;
+		m_visited.set(rank, 1U);
+		m_moves.set(rank, static_cast<std::uint8_t>(trail.move()));
+		m_size++;
+		return true;
+	}
+	std::vector<move_t> moves(board_t<side_size> board) const
+	{
+		std::vector<move_t> ans;
+		while (!(board == m_root))
+		{
+			auto const move = static_cast<move_t>(m_moves.get(ranking_t::rank(board)));
+			ans.push_back(move);
+			board = board.apply(opposite(move));
+		}
+		std::ranges::reverse(ans);
+		return ans;
+	}
+	std::size_t size() const noexcept
+	{
+		return m_size;
+	}
+	//share of the parity class visited
+	double load_factor() const noexcept
+	{
+		return static_cast<double>(m_size) / ranking_t::state_count;
+	}
+private:
+	packed_array_t<1> m_visited;
+	packed_array_t<2> m_moves;
+	board_t<side_size> m_root = ranking_t::unrank(0U);
+	std::size_t m_size = 0U;
+};
+
+//A node reached again on a shorter path before its expansion gets the shorter
+//trail and a second open list entry; the outdated entry is skipped once the node
+//is expanded. With a consistent heuristic expanded nodes are never improved.
+template <std::uint8_t side_size, typename heuristic_t = manhattan_t, template <typename> typename open_list_t = bucket_open_list_t>
+class astar_t
 {
-	using history_t = std::unordered_map<board_t<side_size>, std::uint8_t>;
-	history_t history;
-	auto cmp = [](auto const lhs, auto const rhs) noexcept
+public:
+	explicit astar_t(heuristic_t const& heuristic = {}, std::size_t const expected = expected_nodes<side_size>())
+		: m_heuristic{ heuristic }
+	{
+		m_explored_nodes.reserve(expected);
+	}
+	//closed list nodes that fit into bytes, for expected_nodes()
+	static std::size_t node_budget(std::size_t const bytes) noexcept
+	{
+		return bytes / history_t::bytes_per_node();
+	}
+	search_result_t operator()(board_t<side_size> const start, board_t<side_size> const goal)
+	{
+		search_result_t ans;
+		{
+			scoped_phase_t const phase{ ans.counters.phases, "search" };
+			m_explored_nodes.clear();
+			m_frontier.clear();
+			m_frontier.push(m_heuristic(start), 0U, m_explored_nodes.try_emplace(start, node_t{}).first);
+			ans.counters.generations = 1U;
+			while (!m_frontier.empty())
+			{
+				auto const [cost, parent] = m_frontier.pop();
+				if (m_explored_nodes.value(parent).expanded) continue;
+				auto const board = m_explored_nodes.key(parent);
+				auto const parent_depth = m_explored_nodes.value(parent).depth;
+				if (board == goal)
+				{
+					ans.solved = true;
+					ans.depth = parent_depth;
+					ans.cost = cost;
+					break;
+				}
+				m_explored_nodes.value(parent).expanded = true;
+				ans.counters.expand(parent_depth);
+				std::uint16_t const depth = parent_depth + 1U;
+				auto const empty_idx = board.empty_cell_index();
+				for (auto const& neighbor : board.neighbors())
+				{
+					node_t const child{ trail_t{ depth, board_t<side_size>::direction(empty_idx - 1U, neighbor.empty_cell_index() - 1U) } };
+					ans.counters.generations++;
+					auto const [index, inserted] = m_explored_nodes.try_emplace(neighbor, child);
+					if (!inserted)
+					{
+						auto& node = m_explored_nodes.value(index);
+						if (node.expanded || node.depth <= depth)
+						{
+							ans.counters.duplicates++;
+							continue;
+						}
+						node = child;
+					}
+					m_frontier.push(depth + m_heuristic(neighbor), depth, index);
+					ans.max_depth = std::max(ans.max_depth, depth);
+				}
+				ans.counters.open_size(m_frontier.size());
+			}
+			ans.counters.load_factor = m_explored_nodes.load_factor();
+		}
+		if (ans.solved)
+		{
+			scoped_phase_t const phase{ ans.counters.phases, "trace" };
+			ans.moves = trace_moves(m_explored_nodes, goal);
+		}
+		return ans;
+	}
+private:
+	struct node_t : trail_t
 	{
-		return (lhs->second + lhs->first.heuristic()) > (rhs->second + rhs->first.heuristic());
+		bool expanded = false;
 	};
-	std::priority_queue<typename history_t::const_iterator,
-		std::deque<typename history_t::const_iterator>,
-		decltype(cmp)> q(cmp);
-	q.push(history.emplace(start, 0ui16).first);
-	while (!q.empty())
-	{
-		auto const parent = q.top();
-		q.pop();
-		for (auto const& child : parent->first.available_states())
+	using history_t = closed_list_t<board_t<side_size>, node_t>;
+	heuristic_t m_heuristic;
+	history_t m_explored_nodes;
+	open_list_t<typename history_t::index_t> m_frontier;
+};
+
+template <std::uint8_t side_size, typename heuristic_t = manhattan_t, template <typename> typename open_list_t = bucket_open_list_t>
+search_result_t astar(board_t<side_size> const start, board_t<side_size> const goal, heuristic_t const& heuristic = {})
+{
+	return astar_t<side_size, heuristic_t const&, open_list_t>{ heuristic }(start, goal);
+}
+
+//the original entry point, now the same search as astar()
+template <std::uint8_t side_size, typename heuristic_t = manhattan_t, template <typename> typename open_list_t = bucket_open_list_t>
+search_result_t solve(board_t<side_size> const start, board_t<side_size> const target, heuristic_t const& heuristic = {})
+{
+	return astar<side_size, heuristic_t, open_list_t>(start, target, heuristic);
+}
+
+//bfs, dfs and dls only differ in the end of the frontier they expand and in the depth limit
+template <std::uint8_t side_size, typename history_t, bool lifo>
+search_result_t frontier_search(board_t<side_size> const start, board_t<side_size> const goal, std::uint16_t const limit)
+{
+	search_result_t ans;
+	history_t explored_nodes;
+	{
+		scoped_phase_t const phase{ ans.counters.phases, "search" };
+		explored_nodes.reset(start);
+		std::deque<std::pair<board_t<side_size>, std::uint16_t>> frontier;
+		frontier.emplace_back(start, 0U);
+		ans.counters.generations = 1U;
+		while (!frontier.empty())
+		{
+			auto const [parent, parent_depth] = lifo ? frontier.back() : frontier.front();
+			if constexpr (lifo) frontier.pop_back();
+			else frontier.pop_front();
+			if (parent == goal)
+			{
+				ans.solved = true;
+				ans.depth = ans.cost = parent_depth;
+				break;
+			}
+			if (parent_depth >= limit) continue;
+			ans.counters.expand(parent_depth);
+			std::uint16_t const depth = parent_depth + 1U;
+			auto const empty_idx = parent.empty_cell_index();
+			for (auto const& neighbor : parent.neighbors())
+			{
+				trail_t const trail{ depth, board_t<side_size>::direction(empty_idx - 1U, neighbor.empty_cell_index() - 1U) };
+				ans.counters.generations++;
+				if (explored_nodes.insert(neighbor, trail))
+				{
+					frontier.emplace_back(neighbor, depth);
+					ans.max_depth = std::max(ans.max_depth, depth);
+				}
+				else
+				{
+					ans.counters.duplicates++;
+				}
+			}
+			ans.counters.open_size(frontier.size());
+		}
+		ans.counters.load_factor = explored_nodes.load_factor();
+	}
+	if (ans.solved)
+	{
+		scoped_phase_t const phase{ ans.counters.phases, "trace" };
+		ans.moves = explored_nodes.moves(goal);
+	}
+	return ans;
+}
+
+template <std::uint8_t side_size, typename history_t = hashed_history_t<side_size>>
+search_result_t bfs(board_t<side_size> const start, board_t<side_size> const goal)
+{
+	return frontier_search<side_size, history_t, false>(start, goal, trail_t::max_depth);
+}
+
+template <std::uint8_t side_size, typename history_t = hashed_history_t<side_size>>
+search_result_t dfs(board_t<side_size> const start, board_t<side_size> const goal)
+{
+	return frontier_search<side_size, history_t, true>(start, goal, trail_t::max_depth);
+}
+
+template <std::uint8_t side_size, typename history_t = hashed_history_t<side_size>>
+search_result_t dls(board_t<side_size> const start, board_t<side_size> const goal, std::uint16_t const limit)
+{
+	return frontier_search<side_size, history_t, true>(start, goal, limit);
+}
+
+//counters add up over all iterations; a goal in the other parity class is never found,
+//so the limit would grow forever
+template <std::uint8_t side_size, typename history_t = hashed_history_t<side_size>>
+search_result_t iddfs(board_t<side_size> const start, board_t<side_size> const goal)
+{
+	search_result_t ans;
+	if (!start.reaches(goal)) return ans;
+	for (std::uint16_t limit = 0; !ans.solved; limit++)
+	{
+		auto iteration = dls<side_size, history_t>(start, goal, limit);
+		iteration.counters.merge(ans.counters);
+		ans = std::move(iteration);
+	}
+	return ans;
+}
+
+template <std::uint8_t side_size, typename heuristic_t = manhattan_t>
+class idastar_t
+{
+public:
+	explicit idastar_t(heuristic_t const& heuristic = {})
+		: m_heuristic{ heuristic }
+	{
+	}
+	search_result_t operator()(board_t<side_size> const start, board_t<side_size> const goal)
+	{
+		search_result_t ans;
+		//every bound would be exceeded somewhere, so the iterations never run out
+		if (!start.reaches(goal)) return ans;
+		ans.counters.generations = 1U;
+		m_path.clear();
+		m_path.push_back(start);
+		auto search = [&](auto& self, std::uint8_t const previous_idx, std::uint16_t const h, std::uint16_t const bound) -> std::uint16_t
+			{
+				auto const node = m_path.back();
+				auto const depth = static_cast<std::uint16_t>(m_path.size() - 1U);
+				if (depth + h > bound) return depth + h;
+				if (node == goal) return found;
+				ans.counters.expand(depth);
+				ans.max_depth = std::max(ans.max_depth, depth);
+				std::uint16_t next_bound = exhausted;
+				auto const empty_idx = node.empty_cell_index();
+				auto const& moves = board_t<side_size>::move_table[empty_idx - 1U];
+				for (std::uint8_t move = 0; move < moves.count; move++)
+				{
+					std::uint8_t const target_idx = moves.targets[move] + 1U;
+					if (target_idx == previous_idx) continue;
+					auto const child = node.move_empty(empty_idx, target_idx);
+					std::uint16_t child_h;
+					if constexpr (std::same_as<std::remove_cvref_t<heuristic_t>, manhattan_t>)
+					{
+						child_h = h + board_t<side_size>::delta_table[node.tile(target_idx - 1U)][empty_idx - 1U][move];
+					}
+					else
+					{
+						child_h = m_heuristic(child);
+					}
+					ans.counters.generations++;
+					m_path.push_back(child);
+					auto const t = self(self, empty_idx, child_h, bound);
+					if (found == t) return found;
+					m_path.pop_back();
+					next_bound = std::min(next_bound, t);
+				}
+				return next_bound;
+			};
+		std::uint16_t const start_h = m_heuristic(start);
+		for (std::uint16_t bound = start_h; exhausted != bound;)
 		{
-			if (child == target)
 			{
-				return 1;
+				scoped_phase_t const phase{ ans.counters.phases, "search" };
+				bound = search(search, 0U, start_h, bound);
 			}
-			if (parent->second + 1U == std::numeric_limits<std::uint8_t>::max()) continue;
-			if (auto [it, inserted] = history.emplace(child, parent->second + 1U); inserted)
+			if (found == bound)
 			{
-				q.push(it);
+				ans.solved = true;
+				ans.depth = ans.cost = static_cast<std::uint16_t>(m_path.size() - 1U);
+				for (std::size_t i = 1; i < m_path.size(); i++)
+				{
+					ans.moves.push_back(board_t<side_size>::direction(m_path[i - 1U].empty_cell_index() - 1U, m_path[i].empty_cell_index() - 1U));
+				}
+				break;
 			}
 		}
+		return ans;
 	}
-	return 0;
-}
\ No newline at end of file
+private:
+	constexpr static std::uint16_t found = std::numeric_limits<std::uint16_t>::max();
+	constexpr static std::uint16_t exhausted = found - 1U;
+	heuristic_t m_heuristic;
+	std::vector<board_t<side_size>> m_path;
+};
+
+template <std::uint8_t side_size, typename heuristic_t = manhattan_t>
+search_result_t idastar(board_t<side_size> const start, board_t<side_size> const goal, heuristic_t const& heuristic = {})
+{
+	return idastar_t<side_size, heuristic_t const&>{ heuristic }(start, goal);
+}
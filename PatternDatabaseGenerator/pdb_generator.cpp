@@ -0,0 +1,101 @@
+// pdb_generator.cpp : builds the additive pattern databases used by the NPuzzle heuristic searches.
+//
+// usage: pdb_generator <side_size> <output file> [pattern ...]
+// each pattern is a comma separated list of tiles, e.g. 1,5,6,9,10,13
+//
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../NPuzzle/npuzzle_heuristic.hpp"
+
+template <std::uint8_t side_size>
+int generate(char const* path, std::vector<std::vector<std::uint8_t>> partition)
+{
+	using pdb_t = pattern_database_t<side_size>;
+	if (partition.empty())
+	{
+		partition = pdb_t::default_partition();
+	}
+	std::vector<bool> seen(pdb_t::board_size);
+	for (auto const& tiles : partition)
+	{
+		for (auto const tile : tiles)
+		{
+			if (0 == tile || tile >= pdb_t::board_size || seen[tile])
+			{
+				std::cerr << "patterns must be disjoint sets of tiles 1.." << pdb_t::board_size - 1 << '\n';
+				return EXIT_FAILURE;
+			}
+			seen[tile] = true;
+		}
+	}
+	std::ofstream os{ path, std::ios::binary };
+	if (!os)
+	{
+		std::cerr << "cannot open " << path << '\n';
+		return EXIT_FAILURE;
+	}
+	pdb_t::build(os, partition);
+	return os ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//the whole of text as a number in 0..255, nothing otherwise
+std::optional<std::uint8_t> parse_number(std::string_view const text)
+{
+	std::uint8_t ans;
+	auto const [end, error] = std::from_chars(text.data(), text.data() + text.size(), ans);
+	if (std::errc{} != error || text.data() + text.size() != end) return std::nullopt;
+	return ans;
+}
+
+int usage(char const* program)
+{
+	std::cerr << "usage: " << program << " <side_size> <output file> [pattern ...]\n";
+	std::cerr << "each pattern is a comma separated list of tiles, e.g. 1,5,6,9,10,13\n";
+	return EXIT_FAILURE;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		return usage(argv[0]);
+	}
+	std::vector<std::vector<std::uint8_t>> partition;
+	for (int i = 3; i < argc; i++)
+	{
+		std::istringstream is{ argv[i] };
+		auto& tiles = partition.emplace_back();
+		for (std::string tile; std::getline(is, tile, ',');)
+		{
+			auto const number = parse_number(tile);
+			if (!number)
+			{
+				std::cerr << "bad tile '" << tile << "' in pattern " << argv[i] << '\n';
+				return usage(argv[0]);
+			}
+			tiles.push_back(*number);
+		}
+		if (tiles.empty())
+		{
+			std::cerr << "empty pattern\n";
+			return usage(argv[0]);
+		}
+	}
+	switch (parse_number(argv[1]).value_or(0U))
+	{
+	case 3: return generate<3>(argv[2], partition);
+	case 4: return generate<4>(argv[2], partition);
+	default:
+		std::cerr << "supported side sizes: 3, 4\n";
+		return usage(argv[0]);
+	}
+}
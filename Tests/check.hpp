@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdlib>
+#include <iostream>
+#include <source_location>
+#include <string_view>
+
+//The test programs count failed checks and exit with EXIT_FAILURE after any, which is
+//all CTest looks at.
+inline int failures = 0;
+
+inline void check(bool const condition, std::string_view const what, std::source_location const where = std::source_location::current())
+{
+	if (condition) return;
+	failures++;
+	std::cerr << where.file_name() << ':' << where.line() << ": " << what << '\n';
+}
+
+inline int report()
+{
+	if (0 != failures) std::cerr << failures << " checks failed\n";
+	return 0 == failures ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,81 @@
+// closed_list_test.cpp : closed_list_t against std::unordered_map, with a good hash and with
+// one that sends long runs of keys to the same slot.
+//
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+
+#include "../NPuzzle/npuzzle_closed_list.hpp"
+#include "check.hpp"
+
+struct clustered_hash_t
+{
+	std::size_t operator()(std::uint64_t const key) const noexcept
+	{
+		return key / 64U;
+	}
+};
+
+template <typename hash_t>
+void run(std::size_t const count)
+{
+	using list_t = closed_list_t<std::uint64_t, std::uint32_t, hash_t>;
+	list_t list;
+	std::unordered_map<std::uint64_t, typename list_t::index_t> model;
+	std::mt19937_64 gen{ 42 };
+	for (int round = 0; round < 3; round++)
+	{
+		//no reserve: the table rehashes several times and the nodes span several blocks
+		auto const& first = list.value(list.try_emplace(~std::uint64_t{ 0 }, 7U).first);
+		model.emplace(~std::uint64_t{ 0 }, 0U);
+		for (std::size_t i = 0; i < count; i++)
+		{
+			auto const key = gen() % (4U * count);
+			auto const [index, inserted] = list.try_emplace(key, static_cast<std::uint32_t>(key));
+			auto const [it, expected] = model.emplace(key, index);
+			check(inserted == expected, "try_emplace adds exactly the new keys");
+			check(it->second == index, "a key keeps its index");
+			check(key == list.key(index), "key(index) is the key stored there");
+		}
+		check(model.size() == list.size(), "size() counts the distinct keys");
+		check(list.load_factor() <= 7.0 / 8.0, "the table stays below 7/8 load");
+		check(&first == &list.value(0U) && 7U == first, "references survive inserts");
+		for (auto const& [key, index] : model)
+		{
+			check(index == list.find(key), "find() returns the index try_emplace gave");
+		}
+		for (std::size_t i = 0; i < 1000; i++)
+		{
+			auto const key = 4U * count + gen() % count;
+			check(list_t::none == list.find(key) && !list.contains(key), "absent keys are not found");
+		}
+		list.value(list.find(model.begin()->first)) = 1234567U;
+		check(1234567U == list.value(model.begin()->second), "value() is writable");
+		//the second round clears a full table, the third a nearly empty one
+		list.clear();
+		model.clear();
+		check(0U == list.size(), "clear() drops every node");
+		check(list_t::none == list.find(~std::uint64_t{ 0 }), "clear() drops every slot");
+		if (0 == round)
+		{
+			list.reserve(count);
+			check(0.0 == list.load_factor(), "reserve() keeps the list empty");
+		}
+		if (1 == round)
+		{
+			for (std::uint64_t key = 0; key < 100U; key++)
+			{
+				list.try_emplace(key, 0U);
+			}
+			list.clear();
+		}
+	}
+}
+
+int main()
+{
+	run<std::hash<std::uint64_t>>(100000U);
+	run<clustered_hash_t>(20000U);
+	return report();
+}
@@ -0,0 +1,44 @@
+// conflicts_test.cpp : conflicts_t keeps the cost of a board as queens move, and predicts the
+// cost of every neighbor, in agreement with board_t::cost() counting all pairs again.
+//
+#include <cstdint>
+#include <random>
+
+#include "../8QueensPuzzle/queens.hpp"
+#include "check.hpp"
+
+int main()
+{
+	using queens::board_t;
+	using queens::conflicts_t;
+	std::mt19937 gen{ 5 };
+	for (int walk = 0; walk < 2000; walk++)
+	{
+		board_t board{ static_cast<unsigned int>(gen() & 0xFFFFFFU) };
+		conflicts_t conflicts{ board };
+		check(board.cost() == conflicts.cost(), "the counts of a new board give its cost");
+		for (int step = 0; step < 50; step++)
+		{
+			for (int i = 0; i != 8; i++)
+			{
+				auto const q = board.queen_pos(i);
+				for (int j = 0; j != 8; j++)
+				{
+					if (j == q) continue;
+					auto neighbor = board;
+					neighbor.set_queen_pos(i, j);
+					check(neighbor.cost() == conflicts.cost() - conflicts.leaving(i, q) + conflicts.joining(i, j),
+						"leaving and joining give the cost of every neighbor");
+				}
+			}
+			int const i = static_cast<int>(gen() % 8U);
+			int const from = board.queen_pos(i);
+			int const to = static_cast<int>((from + 1U + gen() % 7U) % 8U);
+			board.set_queen_pos(i, to);
+			conflicts.move(i, from, to);
+			check(board.cost() == conflicts.cost(), "move() keeps the cost of the board");
+		}
+		check(conflicts.cost() == conflicts_t{ board }.cost(), "moves end where a recount does");
+	}
+	return report();
+}
@@ -0,0 +1,95 @@
+// open_list_test.cpp : bucket_open_list_t pops in the order of heap_open_list_t, lowest f and
+// deepest g first, and indexed_heap_t keeps the order of a std::set under any erase.
+//
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <set>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "../NPuzzle/npuzzle_open_list.hpp"
+#include "check.hpp"
+
+void bucket_order()
+{
+	std::mt19937 gen{ 7 };
+	bucket_open_list_t<std::uint32_t> bucket;
+	heap_open_list_t<std::uint32_t> heap;
+	//values are push numbers; equal (f, g) entries may leave the two lists in different orders
+	std::vector<std::uint16_t> depths;
+	//pushes never go below the last f popped, as with a consistent heuristic
+	std::uint16_t min_f = 0;
+	for (int step = 0; step < 200000; step++)
+	{
+		if (bucket.empty() || 0U != gen() % 3U)
+		{
+			std::uint16_t const f = min_f + gen() % 8U;
+			std::uint16_t const g = gen() % (f + 1U);
+			bucket.push(f, g, static_cast<std::uint32_t>(depths.size()));
+			heap.push(f, g, static_cast<std::uint32_t>(depths.size()));
+			depths.push_back(g);
+			continue;
+		}
+		auto const [f, value] = bucket.pop();
+		auto const [heap_f, heap_value] = heap.pop();
+		check(f == heap_f && depths[value] == depths[heap_value], "both lists pop the same f and g");
+		check(f >= min_f, "f never decreases");
+		min_f = f;
+	}
+	check(bucket.size() == heap.size(), "both lists hold the same number of entries");
+	bucket.clear();
+	check(bucket.empty(), "clear() empties the list");
+	for (std::uint16_t g = 0; g < 10U; g++)
+	{
+		bucket.push(20U, g, g);
+	}
+	bucket.push(19U, 0U, 100U);
+	check(100U == bucket.pop().second, "the lowest f goes first");
+	for (std::uint16_t g = 10; g-- > 0U;)
+	{
+		auto const [f, value] = bucket.pop();
+		check(20U == f && g == value, "the deepest g of one f goes first");
+	}
+	check(bucket.empty(), "every entry is popped once");
+}
+
+template <typename compare_t>
+void indexed_order()
+{
+	using key_t = std::tuple<std::uint16_t, std::uint16_t, std::uint32_t>;
+	std::mt19937 gen{ 11 };
+	indexed_heap_t<key_t, compare_t> heap;
+	std::set<key_t, compare_t> model;
+	constexpr std::uint32_t ids = 5000;
+	heap.reserve(ids);
+	std::vector<key_t> keys(ids);
+	for (int step = 0; step < 300000; step++)
+	{
+		std::uint32_t const id = gen() % ids;
+		if (heap.contains(id))
+		{
+			heap.erase(id);
+			model.erase(keys[id]);
+		}
+		else
+		{
+			keys[id] = { static_cast<std::uint16_t>(gen() % 50U), static_cast<std::uint16_t>(gen() % 50U), id };
+			heap.push(id, keys[id]);
+			model.insert(keys[id]);
+		}
+		check(model.size() == heap.size(), "the heap holds the ids pushed and not erased");
+		if (!model.empty()) check(std::get<2>(*model.begin()) == heap.top(), "top() is the first key");
+	}
+	heap.clear();
+	check(heap.empty() && !heap.contains(0U), "clear() drops every id");
+}
+
+int main()
+{
+	bucket_order();
+	indexed_order<std::less<>>();
+	indexed_order<std::greater<>>();
+	return report();
+}
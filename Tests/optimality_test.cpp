@@ -0,0 +1,108 @@
+// optimality_test.cpp : every optimal engine finds a solution as long as IDA*'s, with the
+// Manhattan distance and with a pattern database, on boards drawn from fixed seeds.
+//
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../NPuzzle/npuzzle_anytime.hpp"
+#include "../NPuzzle/npuzzle_bidirectional.hpp"
+#include "../NPuzzle/npuzzle_bounded.hpp"
+#include "../NPuzzle/npuzzle_generator.hpp"
+#include "../NPuzzle/npuzzle_heuristic.hpp"
+#include "../NPuzzle/npuzzle_parallel.hpp"
+#include "../NPuzzle/npuzzle_solver.hpp"
+#include "check.hpp"
+
+//the moves lead from start to goal and there are as many as the reported length
+template <std::uint8_t side_size>
+bool valid(search_result_t const& ans, board_t<side_size> start, board_t<side_size> const goal)
+{
+	for (auto const move : ans.moves)
+	{
+		start = start.apply(move);
+	}
+	return ans.solved && start == goal && ans.depth == ans.moves.size();
+}
+
+template <std::uint8_t side_size>
+using engine_t = std::function<search_result_t(board_t<side_size>, board_t<side_size>)>;
+
+template <std::uint8_t side_size>
+void compare(std::vector<board_t<side_size>> const& starts, std::vector<std::pair<std::string_view, engine_t<side_size>>> const& engines)
+{
+	auto const goal = instance_generator_t<side_size>::goal();
+	for (auto const& start : starts)
+	{
+		auto const reference = idastar<side_size>(start, goal);
+		check(valid(reference, start, goal), "idastar solves the instance");
+		for (auto const& [name, engine] : engines)
+		{
+			auto const ans = engine(start, goal);
+			check(valid(ans, start, goal), std::string{ name } + " returns a solution");
+			check(reference.depth == ans.depth, std::string{ name } + " returns an optimal solution");
+		}
+	}
+}
+
+int main()
+{
+	anytime_options_t anytime;
+	anytime.time_budget = std::chrono::minutes{ 1 };
+	std::vector<board_t<3>> starts3;
+	instance_generator_t<3> generator3{ 2024 };
+	for (int i = 0; i < 40; i++)
+	{
+		starts3.push_back(generator3.random_solvable());
+	}
+	starts3.push_back(instance_generator_t<3>::goal());
+	compare<3>(starts3, {
+		{ "astar", [](auto start, auto goal) { return astar<3>(start, goal); } },
+		{ "astar heap", [](auto start, auto goal) { return astar<3, manhattan_t, heap_open_list_t>(start, goal); } },
+		{ "solve", [](auto start, auto goal) { return solve<3>(start, goal); } },
+		{ "hdastar", [](auto start, auto goal) { return hdastar<3>(start, goal, manhattan_t{}, 3U); } },
+		{ "bfs dense", [](auto start, auto goal) { return bfs<3, dense_history_t<3>>(start, goal); } },
+		{ "bibfs", [](auto start, auto goal) { return bibfs<3>(start, goal); } },
+		{ "mm", [](auto start, auto goal) { return mm<3>(start, goal); } },
+		{ "mm heap", [](auto start, auto goal) { return mm<3, heap_open_list_t>(start, goal); } },
+		{ "smastar", [](auto start, auto goal) { return smastar<3>(start, goal); } },
+		{ "smastar 1000 nodes", [](auto start, auto goal) { return smastar<3>(start, goal, manhattan_t{}, 1000U); } },
+		{ "ara", [&anytime](auto start, auto goal) { return ara<3>(start, goal, manhattan_t{}, anytime); } },
+	});
+
+	//a pattern database written next to the test binary
+	std::string const path = "optimality_test_3.pdb";
+	{
+		std::ofstream os{ path, std::ios::binary };
+		pattern_database_t<3>::build(os, { { 1, 2, 3, 4 }, { 5, 6, 7, 8 } });
+	}
+	pattern_database_t<3> const pdb{ path };
+	compare<3>(starts3, {
+		{ "astar pdb", [&pdb](auto start, auto goal) { return astar<3>(start, goal, pdb); } },
+		{ "idastar pdb", [&pdb](auto start, auto goal) { return idastar<3>(start, goal, pdb); } },
+		{ "hdastar pdb", [&pdb](auto start, auto goal) { return hdastar<3>(start, goal, pdb, 2U); } },
+		{ "smastar pdb", [&pdb](auto start, auto goal) { return smastar<3>(start, goal, pdb, 1000U); } },
+		{ "ara pdb", [&pdb, &anytime](auto start, auto goal) { return ara<3>(start, goal, pdb, anytime); } },
+	});
+
+	std::vector<board_t<4>> starts4;
+	instance_generator_t<4> generator4{ 7 };
+	for (int i = 0; i < 12; i++)
+	{
+		starts4.push_back(generator4.random_walk(40U));
+	}
+	compare<4>(starts4, {
+		{ "astar", [](auto start, auto goal) { return astar<4>(start, goal); } },
+		{ "hdastar", [](auto start, auto goal) { return hdastar<4>(start, goal, manhattan_t{}, 3U); } },
+		{ "mm", [](auto start, auto goal) { return mm<4>(start, goal); } },
+		{ "smastar", [](auto start, auto goal) { return smastar<4>(start, goal, manhattan_t{}, std::size_t{ 1 } << 18); } },
+		{ "ara", [&anytime](auto start, auto goal) { return ara<4>(start, goal, manhattan_t{}, anytime); } },
+	});
+	return report();
+}
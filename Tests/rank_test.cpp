@@ -0,0 +1,38 @@
+// rank_test.cpp : permutation_rank_t is a bijection of each 3x3 parity class onto [0, state_count).
+//
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <numeric>
+
+#include "../NPuzzle/npuzzle_rank.hpp"
+#include "check.hpp"
+
+int main()
+{
+	using ranking_t = permutation_rank_t<3>;
+	check(181440U == ranking_t::state_count, "one 3x3 parity class has 9! / 2 boards");
+	for (bool const solvable : { true, false })
+	{
+		for (std::uint64_t r = 0; r < ranking_t::state_count; r++)
+		{
+			auto const board = ranking_t::unrank(r, solvable);
+			check(solvable == board.solvable(), "unrank stays in the requested parity class");
+			check(r == ranking_t::rank(board), "rank(unrank(r)) == r");
+		}
+	}
+	//every one of the 9! boards, so rank is onto as well
+	std::array<std::uint8_t, 9> tiles;
+	std::iota(tiles.begin(), tiles.end(), std::uint8_t{ 0 });
+	std::uint64_t boards = 0;
+	do
+	{
+		board_t<3> const board{ tiles };
+		auto const r = ranking_t::rank(board);
+		check(r < ranking_t::state_count, "rank < state_count");
+		check(board == ranking_t::unrank(r, board.solvable()), "unrank(rank(board)) == board");
+		boards++;
+	} while (std::ranges::next_permutation(tiles).found);
+	check(2U * ranking_t::state_count == boards, "both classes together are all 9! boards");
+	return report();
+}